@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+#include <algebra/modular.hpp>
+
+/**
+ * BarrettReducer computes remainders by runtime modulo without division.
+ *
+ * Moduli below 2^32 use Barrett reduction with precomputed floor(2^64 / m):
+ * estimated quotient is off by at most one, so there's single correction.
+ * Moduli below 2^62 estimate quotient of product by precomputed 1 / m in long
+ * double and correct the remainder computed modulo 2^64.
+ */
+class BarrettReducer {
+ public:
+  explicit BarrettReducer(uint64_t mod)
+      : mod_{mod},
+        inverse_{~uint64_t{0} / mod},
+        real_inverse_{1.0L / static_cast<long double>(mod)} {
+    assert(mod > 0 && mod < (uint64_t{1} << 62));
+  }
+
+  uint64_t mod() const { return mod_; }
+
+  uint64_t Reduce(uint64_t value) const {
+    if (mod_ < (uint64_t{1} << 32)) {
+      auto quotient = static_cast<uint64_t>((static_cast<unsigned __int128>(value) * inverse_) >> 64);
+      uint64_t rest = value - quotient * mod_;
+      return rest >= mod_ ? rest - mod_ : rest;
+    }
+    return Correct(value, static_cast<uint64_t>(static_cast<long double>(value) * real_inverse_));
+  }
+
+  // Both of lhs and rhs should be already reduced.
+  uint64_t Multiply(uint64_t lhs, uint64_t rhs) const {
+    if (mod_ < (uint64_t{1} << 32)) {
+      return Reduce(lhs * rhs);
+    }
+    auto quotient = static_cast<uint64_t>(static_cast<long double>(lhs) * rhs * real_inverse_);
+    return Correct(lhs * rhs, quotient);
+  }
+
+ private:
+  // Returns value - quotient * mod for quotient that's off by at most one.
+  uint64_t Correct(uint64_t value, uint64_t quotient) const {
+    auto rest = static_cast<int64_t>(value - quotient * mod_);
+    if (rest < 0) rest += static_cast<int64_t>(mod_);
+    if (rest >= static_cast<int64_t>(mod_)) rest -= static_cast<int64_t>(mod_);
+    return static_cast<uint64_t>(rest);
+  }
+
+  uint64_t mod_, inverse_;
+  long double real_inverse_;
+};
+
+/**
+ * BarrettModulo<Tag> is context of runtime modulo for BarrettModular<Tag>.
+ * Context becomes current for its thread once it's constructed and restores
+ * previous one on destruction, so contexts can be nested:
+ * ```c++
+ * using Mint = BarrettModular<>;
+ * BarrettModulo<> modulo(1'000'000'007);
+ * Mint x = 5;  // all the operations use 1e9 + 7 until modulo is alive
+ * ```
+ * Values should not outlive context they were created within.
+ */
+template <class Tag = void>
+class BarrettModulo {
+ public:
+  explicit BarrettModulo(int64_t mod)
+      : reducer_(static_cast<uint64_t>(mod)), previous_{current_} {
+    current_ = this;
+  }
+
+  BarrettModulo(const BarrettModulo &) = delete;
+  BarrettModulo &operator=(const BarrettModulo &) = delete;
+
+  ~BarrettModulo() { current_ = previous_; }
+
+  static const BarrettReducer &Current() {
+    assert(current_ != nullptr);
+    return current_->reducer_;
+  }
+
+ private:
+  static inline thread_local BarrettModulo *current_ = nullptr;
+
+  BarrettReducer reducer_;
+  BarrettModulo *previous_;
+};
+
+template <class Tag = void>
+class BarrettModular {
+  using Z = BarrettModular;
+  using Type = int64_t;
+
+ public:
+  using ModuloType = BarrettModulo<Tag>;
+
+  BarrettModular(Type value = {}) : value_{value ? FromSigned(value) : 0} {}
+  explicit operator Type() const { return static_cast<Type>(value_); }
+
+  Z &operator+=(const Z &rhs) {
+    value_ += rhs.value_;
+    if (value_ >= Mod()) value_ -= Mod();
+    return *this;
+  }
+
+  Z &operator-=(const Z &rhs) {
+    if (value_ < rhs.value_) value_ += Mod();
+    value_ -= rhs.value_;
+    return *this;
+  }
+
+  Z &operator*=(const Z &rhs) {
+    value_ = Reducer().Multiply(value_, rhs.value_);
+    return *this;
+  }
+
+  Z &operator/=(const Z &rhs) {
+    auto inverse = inverse_mod(static_cast<Type>(rhs.value_), static_cast<Type>(Mod()));
+    return *this *= Z(inverse);
+  }
+
+  Z operator-() const { return Z() -= *this; }
+
+  Z &operator++() { return *this += Z(1); }
+  Z &operator--() { return *this -= Z(1); }
+
+  bool operator<(const Z &rhs) const { return value_ < rhs.value_; }
+
+  bool operator==(const Z &rhs) const { return value_ == rhs.value_; }
+  bool operator!=(const Z &rhs) const { return !(*this == rhs); }
+
+  friend Z operator+(const Z &lhs, const Z &rhs) { return Z(lhs) += rhs; }
+  friend Z operator-(const Z &lhs, const Z &rhs) { return Z(lhs) -= rhs; }
+  friend Z operator*(const Z &lhs, const Z &rhs) { return Z(lhs) *= rhs; }
+  friend Z operator/(const Z &lhs, const Z &rhs) { return Z(lhs) /= rhs; }
+
+  friend std::istream &operator>>(std::istream &is, Z &value) {
+    Type raw;
+    return is >> raw, value = Z(raw), is;
+  }
+
+  friend std::ostream &operator<<(std::ostream &os, const Z &value) {
+    return os << static_cast<Type>(value);
+  }
+
+ private:
+  static const BarrettReducer &Reducer() { return ModuloType::Current(); }
+  static uint64_t Mod() { return Reducer().mod(); }
+
+  static uint64_t FromSigned(Type value) {
+    uint64_t rest = Reducer().Reduce(static_cast<uint64_t>(value < 0 ? -value : value));
+    return value < 0 && rest ? Mod() - rest : rest;
+  }
+
+  uint64_t value_;
+};
+
+template<class Tag>
+struct is_modular<BarrettModular<Tag>> : std::true_type {};
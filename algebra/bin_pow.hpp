@@ -1,8 +1,43 @@
+#pragma once
+
+#include <cassert>
 #include <cstdint>
+#include <type_traits>
+
+/**
+ * multiplicative_identity<T>::Of(value) is neutral element for products of
+ * values like given one. By default it's T(1) for types constructible from
+ * int, types whose constructor from integer means something else, e.g. size
+ * of Polynomial or Matrix, specialize it. kDefined is false for types
+ * without neutral element.
+ */
+template <class T, class = void>
+struct multiplicative_identity {
+  static constexpr bool kDefined = std::is_constructible_v<T, int>;
 
+  static constexpr T Of(const T & /*value*/) { return T(1); }
+};
+
+/**
+ * Iterative binary pow, needs neutral element only for zero exponent: it's
+ * multiplicative_identity<T>, so types without it should be raised to
+ * positive powers only.
+ */
 template <class T>
-auto BinPow(T base, int64_t exponent) -> T {
-    if (exponent == 1) return base;
-    if (exponent & 1) return base * BinPow(base * base, exponent >> 1);
-    return BinPow(base * base, exponent >> 1);
+constexpr auto BinPow(T base, int64_t exponent) -> T {
+  assert(exponent >= 0);
+  if constexpr (multiplicative_identity<T>::kDefined) {
+    if (exponent == 0) return multiplicative_identity<T>::Of(base);
+  }
+  assert(exponent > 0);
+
+  for (; !(exponent & 1); exponent >>= 1) {
+    base = base * base;
+  }
+  T result = base;
+  while (exponent >>= 1) {
+    base = base * base;
+    if (exponent & 1) result = result * base;
+  }
+  return result;
 }
@@ -1,5 +1,85 @@
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace detail {
+
+/**
+ * Order-preserving map of values to unsigned keys: integers get sign bit
+ * flipped, IEEE-754 values get sign bit flipped if positive and all bits
+ * flipped if negative. Neighbouring keys are neighbouring values, so any
+ * range bisects down to adjacent values within bit width steps.
+ */
+template <class T, class = void>
+struct search_key;
+
+template <class T>
+struct search_key<T, std::enable_if_t<std::is_integral_v<T>>> {
+  using Key = std::make_unsigned_t<T>;
+  static constexpr Key kShift = std::is_signed_v<T> ? Key(1) << (8 * sizeof(T) - 1) : 0;
+
+  static Key ToKey(T value) { return static_cast<Key>(value) ^ kShift; }
+  static T FromKey(Key key) { return static_cast<T>(key ^ kShift); }
+};
+
+template <class T>
+struct search_key<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+  static_assert(sizeof(T) == 4 || sizeof(T) == 8, "only float and double are supported");
+  using Key = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+  static constexpr Key kSign = Key(1) << (8 * sizeof(T) - 1);
+
+  static Key ToKey(T value) {
+    Key bits;
+    std::memcpy(&bits, &value, sizeof(T));
+    return bits & kSign ? ~bits : bits | kSign;
+  }
+
+  static T FromKey(Key key) {
+    Key bits = key & kSign ? key ^ kSign : ~key;
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+  }
+};
+
+// Types like Float go through their double value.
+template <class T, class>
+struct search_key {
+  using Key = uint64_t;
+
+  static Key ToKey(const T &value) { return search_key<double>::ToKey(static_cast<double>(value)); }
+  static T FromKey(Key key) { return T(search_key<double>::FromKey(key)); }
+};
+
+}  // namespace detail
+
+/**
+ * BitBinSearch is BinSearch over keys of values: it bisects ordered bit
+ * representation instead of values, so it stops at adjacent representable
+ * values after at most 8 * sizeof(key) predicate calls, e.g. 64 for double.
+ *
+ * Supports integers, float, double and types explicitly convertible to
+ * and constructible from double such as Float. Semantics are the same as
+ * for BinSearch, NaNs are not allowed.
+ */
+template <class T, class F>
+auto BitBinSearch(T left, T right, F func) -> T {
+  using Keys = detail::search_key<T>;
+  auto lo = Keys::ToKey(left), hi = Keys::ToKey(right);
+  while (true) {
+    auto mid = lo < hi ? lo + (hi - lo) / 2 : lo - (lo - hi) / 2;
+    if (mid == lo) {
+      break;
+    }
+    (func(Keys::FromKey(mid)) ? lo : hi) = mid;
+  }
+  return Keys::FromKey(lo);
+}
+
 /**
  * BinSearch performs binary search on interval [left, right) with given predicate func
  *
@@ -18,15 +98,77 @@
  * In this case you'll get `mid` as a result.
  *
  * @note: floating point are supported
- * Basically, there's no additional code to support floating point ranges,
- * however, implementations iterates until mid = (left + right) / 2 differs from
+ * float and double are bisected by BitBinSearch, which ends with the same
+ * adjacent values as halving does, but in at most 32 or 64 steps. For other
+ * types implementations iterates until mid = (left + right) / 2 differs from
  * both of left and right. Hence, you can use your own class Float with
- * operator+, operator/, operator!= that uses some precision.
+ * operator+, operator/, operator!= that uses some precision, or pass it to
+ * BitBinSearch to bound number of predicate calls.
  */
 template <class T, class F>
 auto BinSearch(T left, T right, F func) -> T {
-  for (T mid; mid = (left + right) / 2, mid != left && mid != right;) {
-    (func(mid) ? left : right) = mid;
+  if constexpr (std::is_floating_point_v<T>) {
+    return BitBinSearch(left, right, func);
+  } else {
+    for (T mid; mid = (left + right) / 2, mid != left && mid != right;) {
+      (func(mid) ? left : right) = mid;
+    }
+    return left;
+  }
+}
+
+/**
+ * ParallelBinSearch is k-ary BitBinSearch: each round evaluates predicate
+ * at `threads` points splitting keys into threads + 1 equal parts, all of
+ * them at once on their own threads, so it takes log_{threads + 1} rounds
+ * instead of log_2. Predicate should be safe to call concurrently.
+ */
+template <class T, class F>
+auto ParallelBinSearch(T left, T right, F func, size_t threads = std::thread::hardware_concurrency()) -> T {
+  using Keys = detail::search_key<T>;
+  using Key = typename Keys::Key;
+  if (threads <= 1) {
+    return BitBinSearch(left, right, func);
+  }
+
+  auto lo = Keys::ToKey(left), hi = Keys::ToKey(right);
+  const bool ascending = lo < hi;
+  std::vector<Key> points(threads);
+  std::vector<char> results(threads);
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+
+  while (true) {
+    Key distance = ascending ? hi - lo : lo - hi, step = distance / (threads + 1);
+    if (distance <= 1) {
+      break;
+    }
+    size_t count = threads;
+    if (step == 0) {
+      // At most threads keys are strictly inside, check each of them.
+      step = 1, count = distance - 1;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      Key offset = step * static_cast<Key>(i + 1);
+      points[i] = ascending ? lo + offset : lo - offset;
+    }
+    for (size_t i = 1; i < count; ++i) {
+      workers.emplace_back([&, i] { results[i] = func(Keys::FromKey(points[i])); });
+    }
+    results[0] = func(Keys::FromKey(points[0]));
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    workers.clear();
+
+    // Predicate is monotone, so the last true point and the next one bound the answer.
+    size_t last_true = 0;
+    while (last_true < count && results[last_true]) {
+      ++last_true;
+    }
+    if (last_true > 0) lo = points[last_true - 1];
+    if (last_true < count) hi = points[last_true];
   }
-  return left;
+  return Keys::FromKey(lo);
 }
@@ -1,26 +1,116 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <utility>
 #include <vector>
 
+#include <algebra/modular.hpp>
+
+/**
+ * Binomial coefficients by factorial tables that grow geometrically on
+ * demand, each growth performs exactly one division.
+ *
+ * For modular T tables never exceed modulo p (which should be prime then),
+ * and coefficients with n >= p are computed by Lucas' theorem from base-p
+ * digits. Const operator() never grows tables, so once they are warmed up
+ * with Reserve, const C<T> might be shared across threads.
+ */
 template <class T>
 struct C {
   std::vector<T> facts, inv_facts;
 
-  explicit C(size_t size) : facts(size, T(1)), inv_facts(size, T(1)) {
-    for (size_t i = 1; i < size; ++i) {
-      facts[i] = facts[i - 1] * T(i);
+  explicit C(size_t size = 1) { Reserve(size ? size - 1 : 0); }
+
+  size_t size() const { return facts.size(); }
+
+  // Makes tables hold all n up to given one (or up to p - 1 for modular T).
+  void Reserve(int64_t n) {
+    auto needed = static_cast<size_t>(std::min(n, Modulo() - 1)) + 1;
+    if (needed <= facts.size()) {
+      return;
     }
 
-    inv_facts[size - 1] = T(1) / facts[size - 1];
-    for (size_t i = size - 1; i > 0; --i) {
-      inv_facts[i - 1] = inv_facts[i] * T(i);
+    const size_t old_size = facts.size();
+    const size_t new_size = std::min(std::max(needed, 2 * old_size), static_cast<size_t>(Modulo()));
+
+    facts.resize(new_size, T(1)), inv_facts.resize(new_size, T(1));
+    for (size_t i = std::max<size_t>(old_size, 1); i < new_size; ++i) {
+      facts[i] = facts[i - 1] * T(static_cast<int64_t>(i));
+    }
+
+    inv_facts[new_size - 1] = T(1) / facts[new_size - 1];
+    for (size_t i = new_size - 1; i > old_size; --i) {
+      inv_facts[i - 1] = inv_facts[i] * T(static_cast<int64_t>(i));
     }
   }
 
-  auto operator()(int64_t n, int64_t k) -> T {
-    if (k > n) {
+  T operator()(int64_t n, int64_t k) {
+    if (k < 0 || k > n) {
       return T(0);
     }
+    Reserve(TableIndex(n));
+    return std::as_const(*this)(n, k);
+  }
+
+  T operator()(int64_t n, int64_t k) const {
+    if (k < 0 || k > n) {
+      return T(0);
+    }
+    if (n >= Modulo()) {
+      return Lucas(n, k);
+    }
+    assert(static_cast<size_t>(n) < facts.size());
     return facts[n] * inv_facts[k] * inv_facts[n - k];
   }
+
+  // Answers all the (n, k) queries growing tables at most once.
+  std::vector<T> Batch(const std::vector<std::pair<int64_t, int64_t>> &queries) {
+    int64_t max_index = 0;
+    for (auto [n, k] : queries) {
+      max_index = std::max(max_index, TableIndex(n));
+    }
+    Reserve(max_index);
+
+    std::vector<T> result;
+    result.reserve(queries.size());
+    for (auto [n, k] : queries) {
+      result.push_back(std::as_const(*this)(n, k));
+    }
+    return result;
+  }
+
+ private:
+  static int64_t Modulo() {
+    if constexpr (is_modular<T>::value) {
+      return static_cast<int64_t>(-T(1)) + 1;
+    } else {
+      return std::numeric_limits<int64_t>::max();
+    }
+  }
+
+  // Returns largest index of tables C(n, k) might need for any k.
+  static int64_t TableIndex(int64_t n) {
+    const int64_t p = Modulo();
+    if (n < p) {
+      return n;
+    }
+    int64_t result = 0;
+    for (; n > 0; n /= p) {
+      result = std::max(result, n % p);
+    }
+    return result;
+  }
+
+  // C(n, k) = prod C(n_i, k_i) mod p over base-p digits of n and k.
+  T Lucas(int64_t n, int64_t k) const {
+    const int64_t p = Modulo();
+    T result(1);
+    for (; n > 0 && result != T(0); n /= p, k /= p) {
+      result *= (*this)(n % p, k % p);
+    }
+    return result;
+  }
 };
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <algebra/fft.hpp>
+#include <algebra/modular.hpp>
+#include <algebra/multiply_mod.hpp>
+#include <algebra/real_fft.hpp>
+
+/**
+ * Multiplication of sequences with kernel picked by their sizes: schoolbook
+ * for tiny ones, Karatsuba for medium ones and transforms for large ones.
+ * Thresholds are measured by benchmarks/convolution-benchmark.cc.
+ */
+namespace convolution {
+
+template <class T, class = void>
+struct thresholds {
+  // Schoolbook is used while shorter operand has at most that many values.
+  static constexpr size_t kSchoolbook = 32;
+  // Karatsuba is used while shorter operand has at most that many values.
+  static constexpr size_t kKaratsuba = 64;
+};
+
+// NTT by compile-time NTT-friendly modulo beats Karatsuba already at 64 values
+// and schoolbook from 64 on, so such moduli skip Karatsuba at all, while
+// fft::multiply_mod for other moduli loses to Karatsuba up to 64.
+template <class T>
+struct thresholds<T, std::enable_if_t<is_modular<T>::value>> {
+  static constexpr bool kStaticNtt = fft::static_modulo<T>::value != 0 && fft::detail::may_use_ntt<T>();
+
+  static constexpr size_t kSchoolbook = 32;
+  static constexpr size_t kKaratsuba = kStaticNtt ? kSchoolbook : 64;
+};
+
+template <class T>
+struct thresholds<T, std::enable_if_t<std::is_integral_v<T>>> {
+  static constexpr size_t kSchoolbook = 64;
+  static constexpr size_t kKaratsuba = 128;
+};
+
+template <class T>
+std::vector<T> schoolbook(const std::vector<T> &lhs, const std::vector<T> &rhs) {
+  if (lhs.empty() || rhs.empty()) {
+    return {};
+  }
+  std::vector<T> result(lhs.size() + rhs.size() - 1, T(0));
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    for (size_t j = 0; j < rhs.size(); ++j) {
+      result[i + j] += lhs[i] * rhs[j];
+    }
+  }
+  return result;
+}
+
+namespace detail {
+
+// Scratch memory detail::karatsuba needs for operands of given size.
+inline size_t karatsuba_scratch(size_t size) { return 8 * size + 256; }
+
+/**
+ * Adds product of [lhs, lhs + size) and [rhs, rhs + size) to out[0, 2 * size - 1),
+ * all the temporaries live in scratch of karatsuba_scratch(size) values.
+ */
+template <class T>
+void karatsuba(const T *lhs, const T *rhs, size_t size, T *out, T *scratch) {
+  if (size <= thresholds<T>::kSchoolbook) {
+    for (size_t i = 0; i < size; ++i) {
+      for (size_t j = 0; j < size; ++j) {
+        out[i + j] += lhs[i] * rhs[j];
+      }
+    }
+    return;
+  }
+
+  // (a x^h + b)(c x^h + d) = ac x^2h + ((a + b)(c + d) - ac - bd) x^h + bd
+  const size_t half = size / 2, high = size - half;
+  T *low_product = scratch, *high_product = low_product + (2 * half - 1);
+  T *middle = high_product + (2 * high - 1), *lhs_sum = middle + (2 * high - 1);
+  T *rhs_sum = lhs_sum + high, *rest = rhs_sum + high;
+
+  std::fill(low_product, lhs_sum, T(0));
+  karatsuba(lhs, rhs, half, low_product, rest);
+  karatsuba(lhs + half, rhs + half, high, high_product, rest);
+
+  std::copy(lhs + half, lhs + size, lhs_sum), std::copy(rhs + half, rhs + size, rhs_sum);
+  for (size_t i = 0; i < half; ++i) {
+    lhs_sum[i] += lhs[i], rhs_sum[i] += rhs[i];
+  }
+  karatsuba(lhs_sum, rhs_sum, high, middle, rest);
+
+  for (size_t i = 0; i < 2 * half - 1; ++i) {
+    out[i] += low_product[i], middle[i] -= low_product[i];
+  }
+  for (size_t i = 0; i < 2 * high - 1; ++i) {
+    out[i + 2 * half] += high_product[i], middle[i] -= high_product[i];
+  }
+  for (size_t i = 0; i < 2 * high - 1; ++i) {
+    out[i + half] += middle[i];
+  }
+}
+
+}  // namespace detail
+
+/**
+ * Karatsuba multiplication in O(n^log2(3)), shorter operand is padded by
+ * zeros, so it's meant for operands of similar sizes.
+ */
+template <class T>
+std::vector<T> karatsuba(std::vector<T> lhs, std::vector<T> rhs) {
+  if (lhs.empty() || rhs.empty()) {
+    return {};
+  }
+  const size_t result_size = lhs.size() + rhs.size() - 1;
+  const size_t size = std::max(lhs.size(), rhs.size());
+  lhs.resize(size, T(0)), rhs.resize(size, T(0));
+
+  std::vector<T> result(2 * size - 1, T(0)), scratch(detail::karatsuba_scratch(size));
+  detail::karatsuba(lhs.data(), rhs.data(), size, result.data(), scratch.data());
+  result.resize(result_size);
+  return result;
+}
+
+/**
+ * Multiplies with transforms: modular values exactly via NTT or
+ * fft::multiply_mod, integers via double transform with two-for-one packing,
+ * all the other types via complex transform rounded to the nearest integer.
+ */
+template <class T>
+std::vector<T> transform(const std::vector<T> &lhs, const std::vector<T> &rhs) {
+  if (lhs.empty() || rhs.empty()) {
+    return {};
+  }
+  const size_t size = lhs.size() + rhs.size() - 1;
+
+  if constexpr (is_modular<T>::value) {
+    return fft::multiply_modular(lhs, rhs);
+  } else if constexpr (std::is_integral_v<T>) {
+    auto result = fft::multiply_integer(std::vector<int64_t>(lhs.begin(), lhs.end()),
+                                        std::vector<int64_t>(rhs.begin(), rhs.end()));
+    return std::vector<T>(result.begin(), result.end());
+  } else {
+    using Num = std::complex<long double>;
+    auto result = fft::multiply(std::vector<Num>(lhs.begin(), lhs.end()),
+                                std::vector<Num>(rhs.begin(), rhs.end()));
+
+    std::vector<T> rounded(size);
+    for (size_t i = 0; i < size; ++i) {
+      rounded[i] = llround(result[i].real());
+    }
+    return rounded;
+  }
+}
+
+/**
+ * ConvolutionWorkspace owns all the scratch buffers multiplication needs and
+ * keeps them between calls, so that repeated products of bounded sizes
+ * allocate nothing once buffers have grown.
+ *
+ * Kernel is picked like convolution::multiply does: schoolbook, Karatsuba
+ * or transform by size of shorter operand, and longer operand is cut into
+ * chunks of shorter's size when it's more than twice longer. Transforms are
+ * allocation-free for NTT-friendly moduli (by cached fft::plan, on single
+ * thread for any size), all the other transforms go through
+ * convolution::transform and do allocate.
+ * Buffers take memory from given allocator.
+ */
+template <class T, class Allocator = std::allocator<T>>
+class ConvolutionWorkspace {
+ public:
+  explicit ConvolutionWorkspace(const Allocator &allocator = Allocator())
+      : padded_(allocator), product_(allocator), scratch_(allocator) {}
+
+  /**
+   * Writes product of lhs and rhs to out of lhs.size() + rhs.size() - 1
+   * values (or empty one if any operand is empty), out may not overlap
+   * with operands.
+   */
+  void MultiplyInto(ModularSpan<T> out, ModularSpan<const T> lhs, ModularSpan<const T> rhs) {
+    if (lhs.size() < rhs.size()) {
+      std::swap(lhs, rhs);
+    }
+    std::fill(out.begin(), out.end(), T(0));
+    if (rhs.size() == 0) {
+      return;
+    }
+    assert(out.size() == lhs.size() + rhs.size() - 1);
+    AddProduct(out.data(), lhs.data(), lhs.size(), rhs.data(), rhs.size());
+  }
+
+ private:
+  // Adds product of lhs and no longer rhs to out.
+  void AddProduct(T *out, const T *lhs, size_t lhs_size, const T *rhs, size_t rhs_size) {
+    if (rhs_size <= thresholds<T>::kSchoolbook) {
+      for (size_t i = 0; i < lhs_size; ++i) {
+        for (size_t j = 0; j < rhs_size; ++j) {
+          out[i + j] += lhs[i] * rhs[j];
+        }
+      }
+      return;
+    }
+
+    if (lhs_size > 2 * rhs_size) {
+      for (size_t begin = 0; begin < lhs_size; begin += rhs_size) {
+        size_t size = std::min(rhs_size, lhs_size - begin);
+        if (size == rhs_size) {
+          AddProduct(out + begin, lhs + begin, size, rhs, rhs_size);
+        } else {
+          AddProduct(out + begin, rhs, rhs_size, lhs + begin, size);
+        }
+      }
+      return;
+    }
+
+    if (rhs_size <= thresholds<T>::kKaratsuba) {
+      Reserve(padded_, lhs_size), Reserve(product_, 2 * lhs_size - 1);
+      Reserve(scratch_, detail::karatsuba_scratch(lhs_size));
+      std::copy(rhs, rhs + rhs_size, padded_.begin());
+      std::fill(padded_.begin() + rhs_size, padded_.begin() + lhs_size, T(0));
+      std::fill(product_.begin(), product_.begin() + (2 * lhs_size - 1), T(0));
+
+      detail::karatsuba(lhs, padded_.data(), lhs_size, product_.data(), scratch_.data());
+      for (size_t i = 0; i < lhs_size + rhs_size - 1; ++i) {
+        out[i] += product_[i];
+      }
+      return;
+    }
+
+    const size_t result_size = lhs_size + rhs_size - 1;
+    if constexpr (is_modular<T>::value && fft::detail::may_use_ntt<T>()) {
+      const size_t size = fft::detail::transform_size(result_size);
+      if (fft::detail::use_ntt<T>(size)) {
+        const auto &transform = fft::plan<T>(size);
+        Reserve(padded_, size), Reserve(product_, size);
+        std::copy(lhs, lhs + lhs_size, product_.begin());
+        std::fill(product_.begin() + lhs_size, product_.begin() + size, T(0));
+        std::copy(rhs, rhs + rhs_size, padded_.begin());
+        std::fill(padded_.begin() + rhs_size, padded_.begin() + size, T(0));
+
+        // Single thread, since worker threads would allocate on every call.
+        transform.Forward(product_.begin(), product_.begin() + size, 1);
+        transform.Forward(padded_.begin(), padded_.begin() + size, 1);
+        batch_kernels<T>::Multiply(product_.data(), product_.data(), padded_.data(), size);
+        transform.Inverse(product_.begin(), product_.begin() + size, 1);
+
+        for (size_t i = 0; i < result_size; ++i) {
+          out[i] += product_[i];
+        }
+        return;
+      }
+    }
+
+    auto product = transform(std::vector<T>(lhs, lhs + lhs_size), std::vector<T>(rhs, rhs + rhs_size));
+    for (size_t i = 0; i < result_size; ++i) {
+      out[i] += product[i];
+    }
+  }
+
+  using Buffer = std::vector<T, Allocator>;
+
+  // Grows buffer to at least given size, it never shrinks.
+  static void Reserve(Buffer &buffer, size_t size) {
+    if (buffer.size() < size) {
+      buffer.resize(std::max(size, 2 * buffer.size()));
+    }
+  }
+
+  Buffer padded_, product_, scratch_;
+};
+
+/**
+ * Writes product of lhs and rhs to out by workspace cached per thread,
+ * arguments are contiguous containers like for batch operations.
+ */
+template <class Out, class Lhs, class Rhs>
+void multiply_into(Out &&out, const Lhs &lhs, const Rhs &rhs) {
+  auto out_span = MakeModularSpan(out);
+  using T = std::remove_const_t<std::remove_reference_t<decltype(out_span[0])>>;
+  thread_local ConvolutionWorkspace<T> workspace;
+  workspace.MultiplyInto(out_span, ModularSpan<const T>(lhs.data(), lhs.size()),
+                         ModularSpan<const T>(rhs.data(), rhs.size()));
+}
+
+template <class T>
+std::vector<T> multiply(const std::vector<T> &lhs, const std::vector<T> &rhs) {
+  if (lhs.empty() || rhs.empty()) {
+    return {};
+  }
+  std::vector<T> result(lhs.size() + rhs.size() - 1);
+  multiply_into(result, lhs, rhs);
+  return result;
+}
+
+}  // namespace convolution
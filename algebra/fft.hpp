@@ -1,77 +1,366 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#include <algebra/barrett.hpp>
+#include <algebra/bin_pow.hpp>
+#include <algebra/modular.hpp>
+#include <algebra/montgomery.hpp>
+#include <algebra/ntt_traits.hpp>
+
 namespace fft {
 
 namespace detail {
 
-int reverse(int number, int logs) {
-  int res = 0;
-  for (int log = 0, rev_log = logs - 1; log < logs; ++log, --rev_log) {
-    if (number & (1 << log)) {
-      res |= 1 << rev_log;
+template <class T>
+struct root_of_unity;
+
+template <class T>
+T root(size_t pow) {
+  return root_of_unity<T>::get(pow);
+}
+
+template <>
+struct root_of_unity<std::complex<long double>> {
+  static std::complex<long double> get(size_t pow) {
+    long double pi = std::acos(-1);
+    return {std::cos(2 * pi / pow), std::sin(2 * pi / pow)};
+  }
+};
+
+/**
+ * Roots of unity for prime modulo p: there's g^((p - 1) / pow) for primitive
+ * root g, hence pow should divide p - 1, e.g. any power of two up to 2^23
+ * works fine for 998'244'353 = 119 * 2^23 + 1.
+ *
+ * Compile-time moduli take roots of power of two orders from constexpr
+ * ntt_traits tables, so they need no setup and composite ones don't compile.
+ * Runtime moduli find primitive root once per modulo.
+ */
+template <class Z>
+struct modular_root_of_unity {
+  using Type = int64_t;
+
+  static Type primitive(Type mod) {
+    std::vector<Type> divisors;
+    Type rest = mod - 1;
+    for (Type div = 2; div * div <= rest; ++div) {
+      if (rest % div == 0) {
+        divisors.push_back(div);
+        while (rest % div == 0) rest /= div;
+      }
+    }
+    if (rest > 1) divisors.push_back(rest);
+
+    for (Type candidate = 2;; ++candidate) {
+      bool is_primitive = true;
+      for (auto div : divisors) {
+        if (BinPow(Z(candidate), (mod - 1) / div) == Z(1)) {
+          is_primitive = false;
+          break;
+        }
+      }
+      if (is_primitive) return candidate;
     }
   }
-  return res;
-}
 
+  static Z get(size_t pow) {
+    if constexpr (static_modulo<Z>::value != 0) {
+      using Traits = ntt_traits<static_modulo<Z>::value>;
+      if (!(pow & (pow - 1))) {
+        assert(pow <= Traits::kMaxSize);
+        return Z(Traits::kRoots[__builtin_ctzll(pow)]);
+      }
+    }
+
+    thread_local Type cached_mod = 0, cached_root = 0;
+    Type mod = static_cast<Type>(-Z(1)) + 1;
+    assert((mod - 1) % static_cast<Type>(pow) == 0);
+
+    if (cached_mod != mod) {
+      cached_mod = mod, cached_root = primitive(mod);
+    }
+    return BinPow(Z(cached_root), (mod - 1) / static_cast<Type>(pow));
+  }
+};
+
+template <class Modulo>
+struct root_of_unity<Modular<Modulo>> : modular_root_of_unity<Modular<Modulo>> {};
+
+template <class Modulo>
+struct root_of_unity<MontgomeryModular<Modulo>>
+    : modular_root_of_unity<MontgomeryModular<Modulo>> {};
+
+template <class Tag>
+struct root_of_unity<BarrettModular<Tag>> : modular_root_of_unity<BarrettModular<Tag>> {};
+
+/**
+ * Values that rely on thread-local state can't be transformed by several
+ * threads, e.g. BarrettModular reads its modulo from context of the thread.
+ */
 template <class T>
-T root(size_t pow);
+struct is_thread_agnostic : std::true_type {};
 
-template <>
-std::complex<long double> root(size_t pow) {
-  long double pi = std::acos(-1);
-  return {std::cos(2 * pi / pow), std::sin(2 * pi / pow)};
+template <class Tag>
+struct is_thread_agnostic<BarrettModular<Tag>> : std::false_type {};
+
+/**
+ * Transforms below that size are performed by single thread by default,
+ * since spawning threads costs more than they save.
+ */
+constexpr size_t kParallelSize = size_t{1} << 18;
+
+/**
+ * Rounds requested number of threads down to power of two, so that each
+ * thread gets at least two values. Zero stands for hardware concurrency
+ * for transforms of at least kParallelSize values and single thread otherwise.
+ */
+template <class T>
+size_t thread_count(size_t threads, size_t size) {
+  if (!is_thread_agnostic<T>::value) {
+    return 1;
+  }
+  if (!threads) {
+    threads = size >= kParallelSize ? std::max(1u, std::thread::hardware_concurrency()) : 1;
+  }
+
+  size_t result = 1;
+  while (2 * result <= threads && 4 * result <= size) {
+    result *= 2;
+  }
+  return result;
+}
+
+/**
+ * Reusable barrier: Wait() returns once all the threads have called it,
+ * single thread never blocks.
+ */
+class Barrier {
+ public:
+  explicit Barrier(size_t threads) : threads_(threads) {}
+
+  void Wait() {
+    if (threads_ == 1) {
+      return;
+    }
+    std::unique_lock lock(mutex_);
+    const size_t generation = generation_;
+    if (++waiting_ == threads_) {
+      waiting_ = 0, ++generation_;
+      released_.notify_all();
+      return;
+    }
+    released_.wait(lock, [&] { return generation != generation_; });
+  }
+
+ private:
+  const size_t threads_;
+  size_t waiting_ = 0, generation_ = 0;
+  std::mutex mutex_;
+  std::condition_variable released_;
+};
+
+// Calls func(0), ..., func(threads - 1) in parallel, func(0) on current thread.
+template <class Func>
+void parallel_for(size_t threads, Func &&func) {
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (size_t thread = 1; thread < threads; ++thread) {
+    workers.emplace_back([&func, thread] { func(thread); });
+  }
+  func(0);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+/**
+ * Returns smallest power of two that's not less than size.
+ */
+inline size_t transform_size(size_t size) {
+  size_t result = 1;
+  while (result < size) result <<= 1;
+  return result;
 }
 
 }  // namespace detail
 
-template<class T, class It>
-void FFT(It begin, It end, T base) {
-  const int size = static_cast<int>(std::distance(begin, end));
-  int logs = __builtin_ctz(size);
+/**
+ * FftPlan stores everything transform of fixed size needs: bit-reversal
+ * permutation and twiddles for each butterfly layer, so that applying it
+ * performs no setup at all.
+ *
+ * Twiddles for layer with half-length `bit` are stored at [bit, 2 * bit),
+ * i.e. roots_[bit + j] = base^(j * size / (2 * bit)). Only the topmost layer
+ * is actually computed, each lower one is every second root of upper one.
+ * Top layer uses base^j = base^(j mod B) * base^(B * (j / B)) for B ~ sqrt(size)
+ * to keep error of complex roots independent of size.
+ */
+template <class T>
+class FftPlan {
+ public:
+  FftPlan(size_t size, T base)
+      : base_{base},
+        inv_size_{T(1) / T(static_cast<int64_t>(size))},
+        reversed_(size),
+        roots_(std::max<size_t>(size, 2), T(1)) {
+    assert(size && !(size & (size - 1)));
+    int logs = __builtin_ctzll(size);
+
+    for (size_t index = 1; index < size; ++index) {
+      reversed_[index] = (reversed_[index >> 1] >> 1) | ((index & 1) << (logs - 1));
+    }
+
+    size_t half = size / 2, block = 1;
+    while (block * block < half) block <<= 1;
 
-  for (int index = 0; index < size; ++index) {
-    auto rev = detail::reverse(index, logs);
-    if (rev < index) {
-      std::swap(*(begin + index), *(begin + rev));
+    std::vector<T> small(block, T(1)), large((half + block - 1) / block, T(1));
+    for (size_t i = 1; i < small.size(); ++i) small[i] = small[i - 1] * base;
+    T step = small.back() * base;
+    for (size_t i = 1; i < large.size(); ++i) large[i] = large[i - 1] * step;
+
+    for (size_t j = 0; j < half; ++j) {
+      roots_[half + j] = small[j % block] * large[j / block];
+    }
+    for (size_t bit = half / 2; bit > 0; bit /= 2) {
+      for (size_t j = 0; j < bit; ++j) {
+        roots_[bit + j] = roots_[2 * bit + 2 * j];
+      }
     }
   }
 
-  std::vector<T> pows{base};
-  for (int i = 0; i + 1 < logs; ++i) {
-    pows.push_back(pows.back() * pows.back());
+  size_t size() const { return reversed_.size(); }
+  const T &base() const { return base_; }
+
+  /**
+   * Computes values at base^0, base^1, ..., base^(size - 1) in place.
+   *
+   * With several threads each of them permutes its own range of indices,
+   * then transforms its own contiguous chunk of size / threads values through
+   * all the lower layers, and remaining log(threads) upper layers are split
+   * evenly between threads. Threads are started once per call and wait for
+   * each other on barrier between these stages.
+   * Every value is computed by exactly the same operations in any case, so
+   * result doesn't depend on number of threads.
+   */
+  template <class It>
+  void Forward(It begin, [[maybe_unused]] It end, size_t threads = 1) const {
+    const size_t size = this->size();
+    assert(static_cast<size_t>(std::distance(begin, end)) == size);
+
+    threads = detail::thread_count<T>(threads, size);
+    const size_t chunk = size / threads;
+
+    detail::Barrier barrier(threads);
+    detail::parallel_for(threads, [&](size_t thread) {
+      const size_t from = thread * chunk, to = from + chunk;
+      Permute(begin, from, to);
+      barrier.Wait();
+
+      for (size_t bit = 1; bit < chunk; bit <<= 1) {
+        for (size_t start = from; start < to; start += 2 * bit) {
+          Butterflies(begin + start, bit, 0, bit);
+        }
+      }
+
+      for (size_t bit = chunk; bit < size; bit <<= 1) {
+        barrier.Wait();
+        size_t first = from / 2, start = first / bit * 2 * bit;
+        Butterflies(begin + start, bit, first % bit, first % bit + chunk / 2);
+      }
+    });
   }
 
-  for (int log = 0; log < logs; ++log) {
-    auto bit = 1 << log;
-    T mult = pows[logs - log - 1];
+  /**
+   * Reverts Forward: transform by base^-1 is transform by base followed by
+   * reversing all values but first one.
+   */
+  template <class It>
+  void Inverse(It begin, It end, size_t threads = 1) const {
+    Forward(begin, end, threads);
+    std::reverse(begin + 1, end);
+    for (auto it = begin; it != end; ++it) {
+      *it *= inv_size_;
+    }
+  }
 
-    for (int start = 0; start < size; start += 2 * bit) {
-      T pow = 1;
-      for (int index = start; index < start + bit; ++index, pow *= mult) {
-        T lhs = *(begin + index), rhs = *(begin + index + bit) * pow;
-        *(begin + index) = lhs + rhs, *(begin + index + bit) = lhs - rhs;
+ private:
+  template <class It>
+  void Permute(It begin, size_t from, size_t to) const {
+    for (size_t index = from; index < to; ++index) {
+      if (reversed_[index] < index) {
+        std::swap(*(begin + index), *(begin + reversed_[index]));
       }
     }
   }
-}
 
+  // Butterflies of block starting at lower with half-length bit for j in [from, to).
+  template <class It>
+  void Butterflies(It lower, size_t bit, size_t from, size_t to) const {
+    const T *twiddles = roots_.data() + bit;
+    auto upper = lower + bit;
+    for (size_t j = from; j < to; ++j) {
+      T lhs = *(lower + j), rhs = *(upper + j) * twiddles[j];
+      *(lower + j) = lhs + rhs, *(upper + j) = lhs - rhs;
+    }
+  }
+
+  T base_, inv_size_;
+  std::vector<size_t> reversed_;
+  std::vector<T> roots_;
+};
+
+/**
+ * Returns plan for transform of given size built with default root.
+ * Plans are cached per thread and rebuilt only when root changes, e.g. when
+ * DynamicModulo gets another value.
+ */
 template <class T>
-std::vector<T> multiply(std::vector<T> lhs, std::vector<T> rhs) {
-  auto size = lhs.size() + rhs.size() - 1;
-  size = 1 << (32 - __builtin_clz(size));
+const FftPlan<T> &plan(size_t size) {
+  thread_local std::vector<std::unique_ptr<FftPlan<T>>> plans;
+
+  size_t log = __builtin_ctzll(size);
+  if (plans.size() <= log) {
+    plans.resize(log + 1);
+  }
 
-  lhs.resize(size), rhs.resize(size);
   auto base = detail::root<T>(size);
+  if (!plans[log] || plans[log]->base() != base) {
+    plans[log] = std::make_unique<FftPlan<T>>(size, base);
+  }
+  return *plans[log];
+}
 
-  FFT(lhs.begin(), lhs.end(), base), FFT(rhs.begin(), rhs.end(), base);
-  for (size_t index = 0; index < size; ++index) { lhs[index] *= rhs[index]; }
+template<class T, class It>
+void FFT(It begin, It end, T base) {
+  FftPlan<T>(std::distance(begin, end), base).Forward(begin, end);
+}
+
+/**
+ * Multiplies sequences by cached plan, threads are passed to transforms:
+ * by default large transforms use all the hardware threads.
+ */
+template <class T>
+std::vector<T> multiply(std::vector<T> lhs, std::vector<T> rhs, size_t threads = 0) {
+  auto size = detail::transform_size(lhs.size() + rhs.size() - 1);
+  const auto &transform = plan<T>(size);
 
-  FFT(lhs.begin(), lhs.end(), T(1) / base);
-  for (auto &value : lhs) { value /= size; }
+  lhs.resize(size), rhs.resize(size);
+  transform.Forward(lhs.begin(), lhs.end(), threads);
+  transform.Forward(rhs.begin(), rhs.end(), threads);
+  for (size_t index = 0; index < size; ++index) { lhs[index] *= rhs[index]; }
 
+  transform.Inverse(lhs.begin(), lhs.end(), threads);
   return lhs;
 }
 
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <algebra/polynomial.hpp>
+
+/**
+ * Returns shortest c_1, ..., c_d such that a_i = c_1 a_{i-1} + ... + c_d a_{i-d}
+ * holds for all i >= d by Berlekamp-Massey algorithm in O(n^2). T should be
+ * a field, the recurrence is unique once sequence has at least 2d terms.
+ */
+template <class T>
+std::vector<T> BerlekampMassey(const std::vector<T> &sequence) {
+  // current is connection polynomial 1 - c_1 x - ... - c_d x^d, previous is
+  // the one before the last length change.
+  std::vector<T> current{T(1)}, previous{T(1)};
+  size_t length = 0, shift = 1;
+  T previous_discrepancy = T(1);
+
+  for (size_t i = 0; i < sequence.size(); ++i, ++shift) {
+    T discrepancy = T(0);
+    for (size_t j = 0; j <= length && j < current.size(); ++j) {
+      discrepancy += current[j] * sequence[i - j];
+    }
+    if (discrepancy == T(0)) {
+      continue;
+    }
+
+    auto updated = current;
+    T factor = discrepancy / previous_discrepancy;
+    if (updated.size() < previous.size() + shift) {
+      updated.resize(previous.size() + shift, T(0));
+    }
+    for (size_t j = 0; j < previous.size(); ++j) {
+      updated[j + shift] -= factor * previous[j];
+    }
+
+    if (2 * length <= i) {
+      length = i + 1 - length;
+      previous = std::move(current), previous_discrepancy = discrepancy, shift = 0;
+    }
+    current = std::move(updated);
+  }
+
+  std::vector<T> result(length, T(0));
+  for (size_t j = 1; j <= length && j < current.size(); ++j) {
+    result[j - 1] = T(0) - current[j];
+  }
+  return result;
+}
+
+/**
+ * LinearRecurrence computes n-th term of a_i = c_1 a_{i-1} + ... + c_d a_{i-d}
+ * as sum r_j a_j for r = x^n mod (x^d - c_1 x^{d-1} - ... - c_d) (Fiduccia).
+ * Reduction uses precomputed inverse of reversed characteristic polynomial,
+ * so each step is two multiplications and Nth takes O(M(d) log n), with
+ * M(d) chosen by convolution::multiply.
+ */
+template <class T>
+class LinearRecurrence {
+ public:
+  LinearRecurrence(std::vector<T> initial, const std::vector<T> &coefficients)
+      : initial_(std::move(initial)), modulus_(coefficients.size() + 1) {
+    assert(initial_.size() >= coefficients.size());
+    initial_.resize(coefficients.size());
+
+    const size_t order = coefficients.size();
+    modulus_[order] = T(1);
+    for (size_t i = 0; i < order; ++i) {
+      modulus_[order - 1 - i] = T(0) - coefficients[i];
+    }
+    inverse_ = modulus_.Reversed().Inverse(order);
+  }
+
+  // Finds shortest recurrence of sequence by Berlekamp-Massey.
+  static LinearRecurrence Find(const std::vector<T> &sequence) {
+    return LinearRecurrence(sequence, BerlekampMassey(sequence));
+  }
+
+  size_t order() const { return initial_.size(); }
+
+  T Nth(int64_t n) const {
+    assert(n >= 0);
+    const size_t order = this->order();
+    if (order == 0) {
+      return T(0);
+    }
+    if (static_cast<uint64_t>(n) < order) {
+      return initial_[n];
+    }
+
+    auto power = Polynomial<T>{T(1)};
+    for (int bit = 63 - __builtin_clzll(static_cast<uint64_t>(n)); bit >= 0; --bit) {
+      power = Reduce(power * power);
+      if (n >> bit & 1) {
+        power = Reduce(ShiftedByOne(power));
+      }
+    }
+
+    T result = T(0);
+    for (size_t i = 0; i < power.degree(); ++i) {
+      result += power[i] * initial_[i];
+    }
+    return result;
+  }
+
+ private:
+  static Polynomial<T> ShiftedByOne(const Polynomial<T> &polynomial) {
+    auto result = Polynomial<T>(polynomial.degree() + 1);
+    for (size_t i = 0; i < polynomial.degree(); ++i) {
+      result[i + 1] = polynomial[i];
+    }
+    return result;
+  }
+
+  // Returns remainder of division by modulus_ for polynomial of degree < 2d.
+  Polynomial<T> Reduce(Polynomial<T> polynomial) const {
+    const size_t order = this->order();
+    if (polynomial.degree() <= order) {
+      return polynomial;
+    }
+
+    size_t size = polynomial.degree() - order;
+    assert(size <= order);
+    auto quotient = (polynomial.Reversed().Truncated(size) * inverse_.Truncated(size))
+        .Truncated(size)
+        .Reversed();
+    polynomial -= quotient * modulus_;
+    polynomial.resize(order);
+    return polynomial;
+  }
+
+  std::vector<T> initial_;
+  Polynomial<T> modulus_, inverse_;
+};
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <algebra/modular.hpp>
+
+/**
+ * Dense row-major matrix stored in single contiguous buffer, so matrix[i]
+ * is pointer to i-th row and matrix[i][j] is its element.
+ *
+ * Multiplication transposes rhs once and computes products of blocks of
+ * rows by batch_kernels<T>::Dot, so Modular accumulates raw products lazily
+ * and reduces once per block of kBlock terms.
+ *
+ * Gaussian elimination based operations require T to be a field, e.g.
+ * Z<998'244'353>.
+ */
+template <class T>
+class Matrix {
+ public:
+  explicit Matrix(size_t rows = 0, size_t cols = 0) : rows_{rows}, cols_{cols}, data_(rows * cols, T(0)) {}
+
+  Matrix(std::initializer_list<std::initializer_list<T>> rows)
+      : Matrix(rows.size(), rows.size() ? rows.begin()->size() : 0) {
+    size_t row = 0;
+    for (const auto &values : rows) {
+      assert(values.size() == cols_);
+      std::copy(values.begin(), values.end(), (*this)[row++]);
+    }
+  }
+
+  static Matrix Identity(size_t size) {
+    Matrix result(size, size);
+    for (size_t i = 0; i < size; ++i) {
+      result[i][i] = T(1);
+    }
+    return result;
+  }
+
+  size_t rows() const { return rows_; }
+  size_t cols() const { return cols_; }
+
+  T *operator[](size_t row) { return data_.data() + row * cols_; }
+  const T *operator[](size_t row) const { return data_.data() + row * cols_; }
+
+  bool operator==(const Matrix &rhs) const {
+    return rows_ == rhs.rows_ && cols_ == rhs.cols_ && data_ == rhs.data_;
+  }
+  bool operator!=(const Matrix &rhs) const { return !(*this == rhs); }
+
+  Matrix &operator+=(const Matrix &rhs) {
+    assert(rows_ == rhs.rows_ && cols_ == rhs.cols_);
+    batch_kernels<T>::Add(data_.data(), data_.data(), rhs.data_.data(), data_.size());
+    return *this;
+  }
+
+  Matrix &operator-=(const Matrix &rhs) {
+    assert(rows_ == rhs.rows_ && cols_ == rhs.cols_);
+    batch_kernels<T>::Subtract(data_.data(), data_.data(), rhs.data_.data(), data_.size());
+    return *this;
+  }
+
+  Matrix Transposed() const {
+    Matrix result(cols_, rows_);
+    Transpose(*this, result.data_.data());
+    return result;
+  }
+
+  /**
+   * Writes lhs * rhs into out, which should differ from both of them.
+   * transposed is scratch buffer for rhs^T, so that repeated products of
+   * the same shapes allocate nothing.
+   */
+  static void Multiply(const Matrix &lhs, const Matrix &rhs, Matrix &out, std::vector<T> &transposed) {
+    assert(lhs.cols_ == rhs.rows_ && &out != &lhs && &out != &rhs);
+    out.Assign(lhs.rows_, rhs.cols_);
+    transposed.resize(rhs.data_.size());
+    Transpose(rhs, transposed.data());
+
+    const size_t inner = lhs.cols_;
+    for (size_t row_begin = 0; row_begin < lhs.rows_; row_begin += kBlock) {
+      const size_t row_end = std::min(lhs.rows_, row_begin + kBlock);
+      for (size_t col_begin = 0; col_begin < rhs.cols_; col_begin += kBlock) {
+        const size_t col_end = std::min(rhs.cols_, col_begin + kBlock);
+        for (size_t k = 0; k < inner; k += kBlock) {
+          const size_t length = std::min(inner - k, kBlock);
+          for (size_t i = row_begin; i < row_end; ++i) {
+            const T *lhs_row = lhs[i] + k;
+            T *out_row = out[i];
+            for (size_t j = col_begin; j < col_end; ++j) {
+              out_row[j] += batch_kernels<T>::Dot(lhs_row, transposed.data() + j * inner + k, length);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // Returns number of linearly independent rows.
+  size_t Rank() const {
+    auto copy = *this;
+    return copy.Eliminate(cols_).first;
+  }
+
+  // Requires square matrix.
+  T Determinant() const {
+    assert(rows_ == cols_);
+    auto copy = *this;
+    auto [rank, determinant] = copy.Eliminate(cols_);
+    return rank == rows_ ? determinant : T(0);
+  }
+
+  // Requires square matrix with nonzero determinant.
+  Matrix Inverse() const {
+    assert(rows_ == cols_);
+    const size_t size = rows_;
+
+    Matrix augmented(size, 2 * size);
+    for (size_t i = 0; i < size; ++i) {
+      std::copy((*this)[i], (*this)[i] + size, augmented[i]);
+      augmented[i][size + i] = T(1);
+    }
+    [[maybe_unused]] auto rank = augmented.Eliminate(size).first;
+    assert(rank == size);
+
+    Matrix result(size, size);
+    for (size_t i = 0; i < size; ++i) {
+      std::copy(augmented[i] + size, augmented[i] + 2 * size, result[i]);
+    }
+    return result;
+  }
+
+ private:
+  // Tile size for rows, columns and inner dimension of products.
+  static constexpr size_t kBlock = 64;
+
+  void Assign(size_t rows, size_t cols) {
+    rows_ = rows, cols_ = cols;
+    data_.assign(rows * cols, T(0));
+  }
+
+  static void Transpose(const Matrix &matrix, T *out) {
+    for (size_t row_begin = 0; row_begin < matrix.rows_; row_begin += kBlock) {
+      const size_t row_end = std::min(matrix.rows_, row_begin + kBlock);
+      for (size_t col_begin = 0; col_begin < matrix.cols_; col_begin += kBlock) {
+        const size_t col_end = std::min(matrix.cols_, col_begin + kBlock);
+        for (size_t i = row_begin; i < row_end; ++i) {
+          for (size_t j = col_begin; j < col_end; ++j) {
+            out[j * matrix.rows_ + i] = matrix[i][j];
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Gauss-Jordan elimination by first `columns` columns: pivot rows are
+   * normalized and moved to the top, their columns are zeroed in all the
+   * other rows. Returns rank and product of pivots with sign of swaps.
+   */
+  std::pair<size_t, T> Eliminate(size_t columns) {
+    size_t rank = 0;
+    T determinant = T(1);
+    for (size_t col = 0; col < columns && rank < rows_; ++col) {
+      size_t pivot = rank;
+      while (pivot < rows_ && (*this)[pivot][col] == T(0)) {
+        ++pivot;
+      }
+      if (pivot == rows_) {
+        continue;
+      }
+      if (pivot != rank) {
+        std::swap_ranges((*this)[pivot], (*this)[pivot] + cols_, (*this)[rank]);
+        determinant = T(0) - determinant;
+      }
+
+      T *pivot_row = (*this)[rank];
+      determinant *= pivot_row[col];
+      const T inverse = T(1) / pivot_row[col];
+      for (size_t j = col; j < cols_; ++j) {
+        pivot_row[j] *= inverse;
+      }
+
+      for (size_t i = 0; i < rows_; ++i) {
+        T *row = (*this)[i];
+        if (i == rank || row[col] == T(0)) {
+          continue;
+        }
+        const T factor = row[col];
+        for (size_t j = col; j < cols_; ++j) {
+          row[j] -= factor * pivot_row[j];
+        }
+      }
+      ++rank;
+    }
+    return {rank, determinant};
+  }
+
+  size_t rows_, cols_;
+  std::vector<T> data_;
+};
+
+template <class T>
+Matrix<T> operator+(Matrix<T> lhs, const Matrix<T> &rhs) { return lhs += rhs; }
+
+template <class T>
+Matrix<T> operator-(Matrix<T> lhs, const Matrix<T> &rhs) { return lhs -= rhs; }
+
+template <class T>
+Matrix<T> operator*(const Matrix<T> &lhs, const Matrix<T> &rhs) {
+  Matrix<T> result;
+  std::vector<T> transposed;
+  Matrix<T>::Multiply(lhs, rhs, result, transposed);
+  return result;
+}
+
+template <class T>
+struct multiplicative_identity<Matrix<T>> {
+  static constexpr bool kDefined = true;
+
+  static Matrix<T> Of(const Matrix<T> &value) { return Matrix<T>::Identity(value.rows()); }
+};
+
+/**
+ * Iterative binary pow of square matrix, all the products are written into
+ * two preallocated matrices and single transposition buffer.
+ */
+template <class T>
+Matrix<T> BinPow(Matrix<T> base, int64_t exponent) {
+  assert(base.rows() == base.cols() && exponent >= 0);
+  auto result = multiplicative_identity<Matrix<T>>::Of(base);
+  Matrix<T> product(base.rows(), base.cols());
+  std::vector<T> transposed(base.rows() * base.cols());
+
+  for (; exponent; exponent >>= 1) {
+    if (exponent & 1) {
+      Matrix<T>::Multiply(result, base, product, transposed);
+      std::swap(result, product);
+    }
+    if (exponent > 1) {
+      Matrix<T>::Multiply(base, base, product, transposed);
+      std::swap(base, product);
+    }
+  }
+  return result;
+}
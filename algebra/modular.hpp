@@ -1,14 +1,28 @@
 #pragma once
 
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <istream>
 #include <ostream>
+#include <type_traits>
 #include <utility>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <algebra/bin_pow.hpp>
 
 template<class ValueType>
 struct is_invertible {
   static constexpr bool value = false;
 };
 
+template<class Z>
+struct batch_kernels;
+
 template<class Modulo>
 class Modular {
   using Z = Modular;
@@ -26,7 +40,7 @@ class Modular {
 
   template<std::enable_if_t<is_invertible<Modulo>::value, int> = 0>
   Z &operator/=(const Z &rhs) {
-    value_ *= is_invertible<Modulo>::inverse(rhs.value_);
+    value_ *= is_invertible<Modulo>::inverse(static_cast<Type>(rhs));
     return Normalize();
   }
 
@@ -60,6 +74,8 @@ class Modular {
   }
 
  private:
+  template<class> friend struct batch_kernels;
+
   static Type Mod() { return Modulo::value; }
 
   Z &Normalize() {
@@ -70,19 +86,44 @@ class Modular {
   Type value_;
 };
 
+template<class T>
+struct is_modular : std::false_type {};
+
+template<class Modulo>
+struct is_modular<Modular<Modulo>> : std::true_type {};
+
 template<int64_t mod>
 using Z = Modular<std::integral_constant<int64_t, mod>>;
 
+// Returns x and y such that a x + b y = gcd(a, b), extended Euclid without recursion.
 constexpr auto lrp_gcd(int64_t a, int64_t b) -> std::pair<int64_t, int64_t> {
-  if (!b) {
-    return {1, 0};
-  }
-  int64_t x = 0, y = 0;
-  std::tie(x, y) = lrp_gcd(b, a % b);
-  return {
-      y,
-      x - (a / b) * y,
-  };
+  int64_t x = 1, y = 0, next_x = 0, next_y = 1;
+  while (b) {
+    const int64_t quotient = a / b;
+    const int64_t rest = a - quotient * b;
+    const int64_t updated_x = x - quotient * next_x, updated_y = y - quotient * next_y;
+    a = b, b = rest;
+    x = next_x, y = next_y;
+    next_x = updated_x, next_y = updated_y;
+  }
+  return {x, y};
+}
+
+/**
+ * Returns inverse of number coprime with mod in [0, mod), it's extended
+ * Euclid tracking coefficient of number only.
+ */
+constexpr int64_t inverse_mod(int64_t number, int64_t mod) {
+  int64_t a = number % mod, b = mod, x = 1, next_x = 0;
+  if (a < 0) a += mod;
+  while (b) {
+    const int64_t quotient = a / b;
+    const int64_t rest = a - quotient * b, updated_x = x - quotient * next_x;
+    a = b, b = rest;
+    x = next_x, next_x = updated_x;
+  }
+  assert(a == 1);
+  return x < 0 ? x + mod : x;
 }
 
 template<int64_t mod>
@@ -90,10 +131,16 @@ struct is_invertible<std::integral_constant<int64_t, mod>> {
   static constexpr bool value = true;
 
   constexpr static int64_t inverse(int64_t number) {
-    return lrp_gcd(number, mod).first;
+    return inverse_mod(number, mod);
   }
 };
 
+// Inverse of nonzero residue by prime modulo p as value^(p - 2).
+template<class Z>
+Z FermatInverse(const Z &value) {
+  return BinPow(value, static_cast<int64_t>(-Z(1)) - 1);
+}
+
 template<class T>
 struct DynamicModulo {
   static T value;
@@ -110,6 +157,295 @@ struct is_invertible<DynamicModulo<int64_t>> {
   static constexpr bool value = true;
 
   static int64_t inverse(int64_t number) {
-    return lrp_gcd(number, DynamicModulo<int64_t>::value).first;
+    return inverse_mod(number, DynamicModulo<int64_t>::value);
   }
 };
+
+/**
+ * ModularSpan is non-owning view over contiguous residues, it's implicitly
+ * constructible from any container with data() and size(), e.g. std::vector.
+ */
+template<class Z>
+class ModularSpan {
+ public:
+  ModularSpan(Z *data, size_t size) : data_{data}, size_{size} {}
+
+  template<class Container>
+  ModularSpan(Container &&container) : ModularSpan(container.data(), container.size()) {}
+
+  Z *data() const { return data_; }
+  size_t size() const { return size_; }
+
+  Z &operator[](size_t index) const { return data_[index]; }
+
+  Z *begin() const { return data_; }
+  Z *end() const { return data_ + size_; }
+
+ private:
+  Z *data_;
+  size_t size_;
+};
+
+/**
+ * Scalar implementation of batch operations, it works with any residue type.
+ * Types with better representation specialize batch_kernels on their own.
+ */
+template<class Z>
+struct scalar_batch_kernels {
+  static void Add(Z *out, const Z *lhs, const Z *rhs, size_t size) {
+    for (size_t i = 0; i < size; ++i) out[i] = lhs[i] + rhs[i];
+  }
+
+  static void Subtract(Z *out, const Z *lhs, const Z *rhs, size_t size) {
+    for (size_t i = 0; i < size; ++i) out[i] = lhs[i] - rhs[i];
+  }
+
+  static void Multiply(Z *out, const Z *lhs, const Z *rhs, size_t size) {
+    for (size_t i = 0; i < size; ++i) out[i] = lhs[i] * rhs[i];
+  }
+
+  static void MultiplyAdd(Z *out, const Z *lhs, const Z *rhs, size_t size) {
+    for (size_t i = 0; i < size; ++i) out[i] += lhs[i] * rhs[i];
+  }
+
+  static Z Dot(const Z *lhs, const Z *rhs, size_t size) {
+    Z result = 0;
+    for (size_t i = 0; i < size; ++i) result += lhs[i] * rhs[i];
+    return result;
+  }
+
+  // Montgomery's trick: single division and 3 (size - 1) multiplications.
+  static void Inverse(Z *out, const Z *values, size_t size) {
+    if (!size) return;
+    std::vector<Z> prefix(values, values + size);
+    for (size_t i = 1; i < size; ++i) prefix[i] *= prefix[i - 1];
+
+    Z inverse = Z(1) / prefix[size - 1];
+    for (size_t i = size - 1; i > 0; --i) {
+      Z value = values[i];
+      out[i] = inverse * prefix[i - 1];
+      inverse *= value;
+    }
+    out[0] = inverse;
+  }
+};
+
+template<class Z>
+struct batch_kernels : scalar_batch_kernels<Z> {};
+
+/**
+ * Dot product of Modular accumulates raw products in 128 bits and reduces
+ * only once, so it's exact whenever each scalar product is.
+ *
+ * With AVX2 and 64-bit values by modulo below 2^31 other kernels process
+ * four residues at once and keep exactly the values scalar ones produce,
+ * signs included. Products come from _mm256_mul_epi32, and quotients by
+ * modulo are estimated in doubles. Blocks with residues out of (-m, m),
+ * e.g. built from larger integers and not normalized yet, go to scalar
+ * kernels.
+ */
+template<class Modulo>
+struct batch_kernels<Modular<Modulo>> : scalar_batch_kernels<Modular<Modulo>> {
+  using Z = Modular<Modulo>;
+  using Scalar = scalar_batch_kernels<Z>;
+
+  static Z Dot(const Z *lhs, const Z *rhs, size_t size) {
+    __int128 result = 0;
+    for (size_t i = 0; i < size; ++i) result += lhs[i].value_ * rhs[i].value_;
+    return Z(static_cast<typename Z::Type>(result % Z::Mod()));
+  }
+
+#ifdef __AVX2__
+  static void Add(Z *out, const Z *lhs, const Z *rhs, size_t size) {
+    size_t i = 0;
+    if (Vectorized()) {
+      const Constants constants;
+      for (; i + 4 <= size; i += 4) {
+        __m256i a = Load(lhs + i), b = Load(rhs + i);
+        if (InRange(a, b, constants)) {
+          Store(out + i, Reduce(_mm256_add_epi64(a, b), constants));
+        } else {
+          Scalar::Add(out + i, lhs + i, rhs + i, 4);
+        }
+      }
+    }
+    Scalar::Add(out + i, lhs + i, rhs + i, size - i);
+  }
+
+  static void Subtract(Z *out, const Z *lhs, const Z *rhs, size_t size) {
+    size_t i = 0;
+    if (Vectorized()) {
+      const Constants constants;
+      for (; i + 4 <= size; i += 4) {
+        __m256i a = Load(lhs + i), b = Load(rhs + i);
+        if (InRange(a, b, constants)) {
+          Store(out + i, Reduce(_mm256_sub_epi64(a, b), constants));
+        } else {
+          Scalar::Subtract(out + i, lhs + i, rhs + i, 4);
+        }
+      }
+    }
+    Scalar::Subtract(out + i, lhs + i, rhs + i, size - i);
+  }
+
+  static void Multiply(Z *out, const Z *lhs, const Z *rhs, size_t size) {
+    size_t i = 0;
+    if (Vectorized()) {
+      const Constants constants;
+      for (; i + 4 <= size; i += 4) {
+        __m256i a = Load(lhs + i), b = Load(rhs + i);
+        if (InRange(a, b, constants)) {
+          Store(out + i, MultiplyMod(a, b, constants));
+        } else {
+          Scalar::Multiply(out + i, lhs + i, rhs + i, 4);
+        }
+      }
+    }
+    Scalar::Multiply(out + i, lhs + i, rhs + i, size - i);
+  }
+
+  static void MultiplyAdd(Z *out, const Z *lhs, const Z *rhs, size_t size) {
+    size_t i = 0;
+    if (Vectorized()) {
+      const Constants constants;
+      for (; i + 4 <= size; i += 4) {
+        __m256i a = Load(lhs + i), b = Load(rhs + i), c = Load(out + i);
+        if (InRange(a, b, constants) && InRange(c, c, constants)) {
+          Store(out + i, Reduce(_mm256_add_epi64(c, MultiplyMod(a, b, constants)), constants));
+        } else {
+          Scalar::MultiplyAdd(out + i, lhs + i, rhs + i, 4);
+        }
+      }
+    }
+    Scalar::MultiplyAdd(out + i, lhs + i, rhs + i, size - i);
+  }
+
+ private:
+  static bool Vectorized() {
+    if constexpr (std::is_same_v<typename Z::Type, int64_t>) {
+      return Z::Mod() < (int64_t{1} << 31);
+    } else {
+      return false;
+    }
+  }
+
+  struct Constants {
+    const int64_t mod = Z::Mod();
+    const __m256i modulo = _mm256_set1_epi64x(mod), limit = _mm256_set1_epi64x(2 * mod - 2);
+    const __m256i below = _mm256_set1_epi64x(1 - mod), above = _mm256_set1_epi64x(mod - 1);
+    // Integers below 2^51 by absolute value added to bits of 2^52 + 2^51 are doubles.
+    const __m256i magic = _mm256_set1_epi64x(0x4338'0000'0000'0000);
+    // 1 / m slightly decreased, so that quotient is never overestimated.
+    const __m256d inverse = _mm256_set1_pd((1 - 0x1p-40) / static_cast<double>(mod));
+  };
+
+  static __m256i Load(const Z *data) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+  }
+
+  static void Store(Z *data, __m256i value) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(data), value);
+  }
+
+  // Whether all the lanes of both values are in (-m, m), where results of
+  // arithmetic are: shifted by m - 1 they have neither sign nor comparison bit.
+  static bool InRange(__m256i lhs, __m256i rhs, const Constants &constants) {
+    __m256i lhs_shifted = _mm256_add_epi64(lhs, constants.above);
+    __m256i rhs_shifted = _mm256_add_epi64(rhs, constants.above);
+    __m256i out = _mm256_or_si256(_mm256_or_si256(lhs_shifted, rhs_shifted),
+                                  _mm256_or_si256(_mm256_cmpgt_epi64(lhs_shifted, constants.limit),
+                                                  _mm256_cmpgt_epi64(rhs_shifted, constants.limit)));
+    return _mm256_movemask_pd(_mm256_castsi256_pd(out)) == 0;
+  }
+
+  // value % m for value in (-2m, 2m): it keeps sign of value, like % does.
+  static __m256i Reduce(__m256i value, const Constants &constants) {
+    __m256i high = _mm256_and_si256(_mm256_cmpgt_epi64(value, constants.above), constants.modulo);
+    __m256i low = _mm256_and_si256(_mm256_cmpgt_epi64(constants.below, value), constants.modulo);
+    return _mm256_add_epi64(_mm256_sub_epi64(value, high), low);
+  }
+
+  static __m256d ToDouble(__m256i value, const Constants &constants) {
+    __m256d biased = _mm256_castsi256_pd(_mm256_add_epi64(value, constants.magic));
+    return _mm256_sub_pd(biased, _mm256_castsi256_pd(constants.magic));
+  }
+
+  /**
+   * lhs * rhs % m for lanes in (-m, m). Quotient estimate in doubles is
+   * truncated towards zero and is either exact or one closer to zero, hence
+   * remainder of product by it is in (-2m, 2m) and has sign of product.
+   */
+  static __m256i MultiplyMod(__m256i lhs, __m256i rhs, const Constants &constants) {
+    __m256i product = _mm256_mul_epi32(lhs, rhs);
+    __m256d estimate = _mm256_mul_pd(
+        _mm256_mul_pd(ToDouble(lhs, constants), ToDouble(rhs, constants)), constants.inverse);
+    __m256i quotient = _mm256_cvtepi32_epi64(_mm256_cvttpd_epi32(estimate));
+    return Reduce(_mm256_sub_epi64(product, _mm256_mul_epi32(quotient, constants.modulo)), constants);
+  }
+#endif
+};
+
+template<class Container>
+auto MakeModularSpan(Container &&container) {
+  using Z = std::remove_pointer_t<decltype(container.data())>;
+  return ModularSpan<Z>(container.data(), container.size());
+}
+
+/**
+ * Element-wise operations over contiguous residues of the same size, e.g.
+ * std::vector<Z> or ModularSpan<Z>, results agree with scalar ones.
+ * Output is allowed to coincide with any input.
+ */
+namespace batch {
+
+template<class Out, class Lhs, class Rhs>
+void Add(Out &&out, const Lhs &lhs, const Rhs &rhs) {
+  auto out_span = MakeModularSpan(out);
+  using Z = std::remove_const_t<std::remove_reference_t<decltype(out_span[0])>>;
+  assert(out_span.size() == lhs.size() && lhs.size() == rhs.size());
+  batch_kernels<Z>::Add(out_span.data(), lhs.data(), rhs.data(), out_span.size());
+}
+
+template<class Out, class Lhs, class Rhs>
+void Subtract(Out &&out, const Lhs &lhs, const Rhs &rhs) {
+  auto out_span = MakeModularSpan(out);
+  using Z = std::remove_const_t<std::remove_reference_t<decltype(out_span[0])>>;
+  assert(out_span.size() == lhs.size() && lhs.size() == rhs.size());
+  batch_kernels<Z>::Subtract(out_span.data(), lhs.data(), rhs.data(), out_span.size());
+}
+
+template<class Out, class Lhs, class Rhs>
+void Multiply(Out &&out, const Lhs &lhs, const Rhs &rhs) {
+  auto out_span = MakeModularSpan(out);
+  using Z = std::remove_const_t<std::remove_reference_t<decltype(out_span[0])>>;
+  assert(out_span.size() == lhs.size() && lhs.size() == rhs.size());
+  batch_kernels<Z>::Multiply(out_span.data(), lhs.data(), rhs.data(), out_span.size());
+}
+
+// out[i] += lhs[i] * rhs[i]
+template<class Out, class Lhs, class Rhs>
+void MultiplyAdd(Out &&out, const Lhs &lhs, const Rhs &rhs) {
+  auto out_span = MakeModularSpan(out);
+  using Z = std::remove_const_t<std::remove_reference_t<decltype(out_span[0])>>;
+  assert(out_span.size() == lhs.size() && lhs.size() == rhs.size());
+  batch_kernels<Z>::MultiplyAdd(out_span.data(), lhs.data(), rhs.data(), out_span.size());
+}
+
+// out[i] = 1 / values[i], all the values should be invertible.
+template<class Out, class Values>
+void Inverse(Out &&out, const Values &values) {
+  auto out_span = MakeModularSpan(out);
+  using Z = std::remove_const_t<std::remove_reference_t<decltype(out_span[0])>>;
+  assert(out_span.size() == values.size());
+  batch_kernels<Z>::Inverse(out_span.data(), values.data(), out_span.size());
+}
+
+template<class Lhs, class Rhs>
+auto Dot(const Lhs &lhs, const Rhs &rhs) {
+  auto lhs_span = MakeModularSpan(lhs);
+  using Z = std::remove_const_t<std::remove_reference_t<decltype(lhs_span[0])>>;
+  assert(lhs.size() == rhs.size());
+  return batch_kernels<Z>::Dot(lhs_span.data(), rhs.data(), lhs_span.size());
+}
+
+}  // namespace batch
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <algebra/modular.hpp>
+
+namespace detail {
+
+template <class Word>
+struct montgomery_wide;
+
+template <>
+struct montgomery_wide<uint32_t> { using Type = uint64_t; };
+
+template <>
+struct montgomery_wide<uint64_t> { using Type = unsigned __int128; };
+
+}  // namespace detail
+
+/**
+ * MontgomeryModular stores residue x as x * R mod m for R = 2^32 or R = 2^64,
+ * so that multiplication needs no division at all: product of two words is
+ * reduced with two more multiplications and a shift.
+ *
+ * Modulo should be odd compile-time constant below 2^63, moduli below 2^31
+ * use 32-bit words with 64-bit products, larger ones use 64-bit words
+ * with __int128 products. Otherwise it's drop-in replacement for Modular.
+ */
+template <class Modulo>
+class MontgomeryModular {
+  using Z = MontgomeryModular;
+  using Type = std::remove_cv_t<decltype(Modulo::value)>;
+
+  static constexpr uint64_t kMod = static_cast<uint64_t>(Modulo::value);
+  static_assert(kMod % 2 == 1 && kMod < (uint64_t{1} << 63),
+                "Montgomery form requires odd modulo below 2^63");
+
+  using Word = std::conditional_t<(kMod < (uint64_t{1} << 31)), uint32_t, uint64_t>;
+  using Wide = typename detail::montgomery_wide<Word>::Type;
+  static constexpr int kBits = 8 * sizeof(Word);
+
+  // -m^-1 mod R by Newton's iteration: each step doubles number of correct bits.
+  static constexpr Word NegInverse() {
+    Word inverse = static_cast<Word>(kMod);
+    for (int i = 0; i < 6; ++i) {
+      inverse *= Word(2) - static_cast<Word>(kMod) * inverse;
+    }
+    return static_cast<Word>(-inverse);
+  }
+
+  static constexpr Word RSquared() {
+    Wide r = (Wide(1) << kBits) % kMod;
+    return static_cast<Word>(r * r % kMod);
+  }
+
+  static constexpr Word kNegInverse = NegInverse();
+  static constexpr Word kRSquared = RSquared();
+
+ public:
+  using ModuloType = Modulo;
+
+  MontgomeryModular(Type value = {}) : value_{ToForm(Reduce(value))} {}
+  explicit operator Type() const { return static_cast<Type>(FromForm(value_)); }
+
+  Z &operator+=(const Z &rhs) {
+    value_ += rhs.value_;
+    if (value_ >= kMod) value_ -= kMod;
+    return *this;
+  }
+
+  Z &operator-=(const Z &rhs) {
+    if (value_ < rhs.value_) value_ += kMod;
+    value_ -= rhs.value_;
+    return *this;
+  }
+
+  Z &operator*=(const Z &rhs) {
+    value_ = Redc(Wide(value_) * rhs.value_);
+    return *this;
+  }
+
+  template<std::enable_if_t<is_invertible<Modulo>::value, int> = 0>
+  Z &operator/=(const Z &rhs) {
+    return *this *= Z(is_invertible<Modulo>::inverse(static_cast<Type>(rhs)));
+  }
+
+  Z operator-() const { return Z() -= *this; }
+
+  Z &operator++() { return *this += Z(1); }
+  Z &operator--() { return *this -= Z(1); }
+
+  bool operator<(const Z &rhs) const {
+    return static_cast<Type>(*this) < static_cast<Type>(rhs);
+  }
+
+  bool operator==(const Z &rhs) const { return value_ == rhs.value_; }
+  bool operator!=(const Z &rhs) const { return !(*this == rhs); }
+
+  friend Z operator+(const Z &lhs, const Z &rhs) { return Z(lhs) += rhs; }
+  friend Z operator-(const Z &lhs, const Z &rhs) { return Z(lhs) -= rhs; }
+  friend Z operator*(const Z &lhs, const Z &rhs) { return Z(lhs) *= rhs; }
+
+  template<std::enable_if_t<is_invertible<Modulo>::value, int> = 0>
+  friend Z operator/(const Z &lhs, const Z &rhs) { return Z(lhs) /= rhs; }
+
+  friend std::istream &operator>>(std::istream &is, Z &value) {
+    Type raw;
+    return is >> raw, value = Z(raw), is;
+  }
+
+  friend std::ostream &operator<<(std::ostream &os, const Z &value) {
+    return os << static_cast<Type>(value);
+  }
+
+ private:
+  template<class> friend struct batch_kernels;
+
+  static Word Reduce(Type value) {
+    value %= static_cast<Type>(kMod);
+    return static_cast<Word>(value < 0 ? value + static_cast<Type>(kMod) : value);
+  }
+
+  // Returns t / R mod m for t < m * R, which fits into Wide since m < R / 2.
+  static Word Redc(Wide t) {
+    Word m = static_cast<Word>(t) * kNegInverse;
+    Word u = static_cast<Word>((t + Wide(m) * kMod) >> kBits);
+    return u >= kMod ? static_cast<Word>(u - kMod) : u;
+  }
+
+  static Word ToForm(Word value) { return Redc(Wide(value) * kRSquared); }
+  static Word FromForm(Word value) { return Redc(value); }
+
+  Word value_;
+};
+
+template<class Modulo>
+struct is_modular<MontgomeryModular<Modulo>> : std::true_type {};
+
+template<int64_t mod>
+using MontgomeryZ = MontgomeryModular<std::integral_constant<int64_t, mod>>;
+
+#ifdef __AVX2__
+
+/**
+ * Moduli below 2^31 keep residues as 32-bit words, so batch kernels process
+ * eight of them at once: products are computed separately for even and odd
+ * lanes by _mm256_mul_epu32 and reduced by REDC in 64-bit lanes.
+ * Dot product keeps unreduced REDC results in 64-bit accumulators.
+ */
+template<class Modulo>
+struct batch_kernels<MontgomeryModular<Modulo>>
+    : scalar_batch_kernels<MontgomeryModular<Modulo>> {
+  using Z = MontgomeryModular<Modulo>;
+  using Scalar = scalar_batch_kernels<Z>;
+
+  static constexpr bool kVectorized = std::is_same_v<typename Z::Word, uint32_t>;
+
+  static void Add(Z *out, const Z *lhs, const Z *rhs, size_t size) {
+    size_t i = 0;
+    if constexpr (kVectorized) {
+      for (; i + 8 <= size; i += 8) Store(out + i, AddMod(Load(lhs + i), Load(rhs + i)));
+    }
+    Scalar::Add(out + i, lhs + i, rhs + i, size - i);
+  }
+
+  static void Subtract(Z *out, const Z *lhs, const Z *rhs, size_t size) {
+    size_t i = 0;
+    if constexpr (kVectorized) {
+      for (; i + 8 <= size; i += 8) Store(out + i, SubtractMod(Load(lhs + i), Load(rhs + i)));
+    }
+    Scalar::Subtract(out + i, lhs + i, rhs + i, size - i);
+  }
+
+  static void Multiply(Z *out, const Z *lhs, const Z *rhs, size_t size) {
+    size_t i = 0;
+    if constexpr (kVectorized) {
+      for (; i + 8 <= size; i += 8) Store(out + i, MultiplyMod(Load(lhs + i), Load(rhs + i)));
+    }
+    Scalar::Multiply(out + i, lhs + i, rhs + i, size - i);
+  }
+
+  static void MultiplyAdd(Z *out, const Z *lhs, const Z *rhs, size_t size) {
+    size_t i = 0;
+    if constexpr (kVectorized) {
+      for (; i + 8 <= size; i += 8) {
+        Store(out + i, AddMod(Load(out + i), MultiplyMod(Load(lhs + i), Load(rhs + i))));
+      }
+    }
+    Scalar::MultiplyAdd(out + i, lhs + i, rhs + i, size - i);
+  }
+
+  static Z Dot(const Z *lhs, const Z *rhs, size_t size) {
+    size_t i = 0;
+    Z result = 0;
+    if constexpr (kVectorized) {
+      __m256i even_sum = _mm256_setzero_si256(), odd_sum = _mm256_setzero_si256();
+      for (; i + 8 <= size; i += 8) {
+        __m256i a = Load(lhs + i), b = Load(rhs + i);
+        even_sum = _mm256_add_epi64(even_sum, _mm256_srli_epi64(Redc(_mm256_mul_epu32(a, b)), 32));
+        odd_sum = _mm256_add_epi64(odd_sum, _mm256_srli_epi64(Redc(_mm256_mul_epu32(
+            _mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32))), 32));
+      }
+
+      alignas(32) uint64_t lanes[4];
+      _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), _mm256_add_epi64(even_sum, odd_sum));
+      unsigned __int128 total = 0;
+      for (auto lane : lanes) total += lane;
+      result.value_ = static_cast<typename Z::Word>(total % Z::kMod);
+    }
+    return result + Scalar::Dot(lhs + i, rhs + i, size - i);
+  }
+
+ private:
+  static __m256i Load(const Z *data) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data));
+  }
+
+  static void Store(Z *data, __m256i value) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(data), value);
+  }
+
+  static __m256i Mod() { return _mm256_set1_epi32(static_cast<int>(Z::kMod)); }
+
+  // Residues are below 2m < 2^32, so min picks value - m unless it wraps.
+  static __m256i Correct(__m256i value) {
+    return _mm256_min_epu32(value, _mm256_sub_epi32(value, Mod()));
+  }
+
+  static __m256i AddMod(__m256i lhs, __m256i rhs) {
+    return Correct(_mm256_add_epi32(lhs, rhs));
+  }
+
+  static __m256i SubtractMod(__m256i lhs, __m256i rhs) {
+    __m256i diff = _mm256_sub_epi32(lhs, rhs);
+    return _mm256_min_epu32(diff, _mm256_add_epi32(diff, Mod()));
+  }
+
+  // Takes 64-bit products t, returns t + (t * -m^-1 mod 2^32) * m with
+  // t / 2^32 mod m (up to one extra m) in the upper halves of lanes.
+  static __m256i Redc(__m256i product) {
+    __m256i neg_inverse = _mm256_set1_epi32(static_cast<int>(Z::kNegInverse));
+    __m256i factor = _mm256_mul_epu32(product, neg_inverse);
+    return _mm256_add_epi64(product, _mm256_mul_epu32(factor, Mod()));
+  }
+
+  static __m256i MultiplyMod(__m256i lhs, __m256i rhs) {
+    __m256i even = Redc(_mm256_mul_epu32(lhs, rhs));
+    __m256i odd = Redc(_mm256_mul_epu32(_mm256_srli_epi64(lhs, 32), _mm256_srli_epi64(rhs, 32)));
+    return Correct(_mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0b10101010));
+  }
+};
+
+#endif
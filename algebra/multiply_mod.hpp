@@ -0,0 +1,257 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include <algebra/fft.hpp>
+#include <algebra/montgomery.hpp>
+#include <algebra/real_fft.hpp>
+
+namespace fft {
+
+namespace detail {
+
+// NTT of given size by modulo exists iff it's prime and size divides mod - 1.
+inline bool is_ntt_friendly(uint64_t mod, size_t size) {
+  thread_local uint64_t cached_mod = 0;
+  thread_local bool cached_prime = false;
+  if (cached_mod != mod) {
+    cached_mod = mod, cached_prime = is_prime(mod);
+  }
+  return cached_prime && (mod - 1) % size == 0;
+}
+
+// Whether NTT over T might be instantiated: runtime moduli and prime compile-time ones.
+template <class T>
+constexpr bool may_use_ntt() {
+  constexpr int64_t mod = static_modulo<T>::value;
+  return mod == 0 || (mod > 2 && is_prime(mod));
+}
+
+// Whether transform of given size by T's modulo is NTT.
+template <class T>
+bool use_ntt(size_t size) {
+  constexpr int64_t mod = static_modulo<T>::value;
+  if constexpr (mod == 0) {
+    return is_ntt_friendly(static_cast<int64_t>(-T(1)) + 1, size);
+  } else if constexpr (may_use_ntt<T>()) {
+    return size <= ntt_traits<mod>::kMaxSize;
+  } else {
+    return false;
+  }
+}
+
+template <int64_t prime>
+std::vector<uint64_t> multiply_by_prime(const std::vector<int64_t> &lhs,
+                                        const std::vector<int64_t> &rhs) {
+  using Z = MontgomeryZ<prime>;
+  auto product = multiply(std::vector<Z>(lhs.begin(), lhs.end()),
+                          std::vector<Z>(rhs.begin(), rhs.end()));
+
+  std::vector<uint64_t> result(lhs.size() + rhs.size() - 1);
+  for (size_t i = 0; i < result.size(); ++i) {
+    result[i] = static_cast<uint64_t>(static_cast<int64_t>(product[i]));
+  }
+  return result;
+}
+
+/**
+ * NTT-friendly primes below 2^31 used for CRT, each supports sizes up to
+ * 2^23, and product of all of them exceeds 2^177: that holds
+ * (mod - 1)^2 * 2^22 for any modulo below 2^62 and operands of any size
+ * transforms support.
+ */
+constexpr uint64_t kCrtPrimes[] = {
+    998'244'353, 167'772'161, 469'762'049, 754'974'721, 2'013'265'921, 1'811'939'329,
+};
+
+// Smallest base with base^2 >= mod, residues split into two digits below it.
+inline int64_t split_base(int64_t mod) {
+  auto base = static_cast<int64_t>(std::sqrt(static_cast<long double>(mod)));
+  while (base * base < mod) ++base;
+  while (base > 1 && (base - 1) * (base - 1) >= mod) --base;
+  return base;
+}
+
+/**
+ * Whether split transform keeps all the coefficients of product exact:
+ * digits are below split_base(mod), so sums of their products are bounded
+ * by base^2 min(|lhs|, |rhs|), and that times log of transform size should
+ * stay below kSplitExactBound. Rounding errors were seen from about 2^54 on
+ * (mod 2^31 - 1 with 2^19 terms), the bound keeps eight times margin.
+ */
+constexpr long double kSplitExactBound = 1LL << 51;
+
+inline bool split_is_exact(int64_t mod, size_t lhs_size, size_t rhs_size) {
+  const size_t size = transform_size(lhs_size + rhs_size - 1);
+  const auto digit = static_cast<long double>(split_base(mod) - 1);
+  long double magnitude = digit * digit * std::min(lhs_size, rhs_size);
+  return magnitude * (__builtin_ctzll(size) + 1) < kSplitExactBound;
+}
+
+/**
+ * Splits each residue into c = hi * base + lo with base = split_base(mod)
+ * and multiplies them with four complex transforms of doubles: each operand
+ * is packed as hi + i lo, and spectra of hi and lo parts of lhs are
+ * recovered from L[k] and conj(L[-k]). Exact while split_is_exact holds.
+ */
+inline std::vector<int64_t> multiply_split(const std::vector<int64_t> &lhs,
+                                           const std::vector<int64_t> &rhs,
+                                           int64_t mod) {
+  const int64_t base = split_base(mod);
+
+  const size_t result_size = lhs.size() + rhs.size() - 1;
+  const size_t size = transform_size(result_size);
+  const auto &transform = split_plan(size);
+
+  std::vector<double> l_re(size), l_im(size), r_re(size), r_im(size);
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    l_re[i] = static_cast<double>(lhs[i] / base), l_im[i] = static_cast<double>(lhs[i] % base);
+  }
+  for (size_t i = 0; i < rhs.size(); ++i) {
+    r_re[i] = static_cast<double>(rhs[i] / base), r_im[i] = static_cast<double>(rhs[i] % base);
+  }
+  transform.Forward(l_re.data(), l_im.data());
+  transform.Forward(r_re.data(), r_im.data());
+
+  // hi[k] = (L[k] + conj(L[-k])) / 2, lo[k] = (L[k] - conj(L[-k])) / 2i,
+  // then hi * R and lo * R hold hi * hi + i hi * lo and lo * hi + i lo * lo.
+  std::vector<double> x_re(size), x_im(size), y_re(size), y_im(size);
+  for (size_t k = 0; k < size; ++k) {
+    size_t j = (size - k) & (size - 1);
+    double hi_re = (l_re[k] + l_re[j]) / 2, hi_im = (l_im[k] - l_im[j]) / 2;
+    double lo_re = (l_im[k] + l_im[j]) / 2, lo_im = (l_re[j] - l_re[k]) / 2;
+
+    x_re[k] = hi_re * r_re[k] - hi_im * r_im[k], x_im[k] = hi_re * r_im[k] + hi_im * r_re[k];
+    y_re[k] = lo_re * r_re[k] - lo_im * r_im[k], y_im[k] = lo_re * r_im[k] + lo_im * r_re[k];
+  }
+  transform.Inverse(x_re.data(), x_im.data());
+  transform.Inverse(y_re.data(), y_im.data());
+
+  const int64_t base_mod = base % mod, square_mod = base * base % mod;
+  std::vector<int64_t> result(result_size);
+  for (size_t i = 0; i < result_size; ++i) {
+    int64_t high = std::llround(x_re[i]) % mod;
+    int64_t middle = (std::llround(x_im[i]) + std::llround(y_re[i])) % mod;
+    int64_t low = std::llround(y_im[i]) % mod;
+    result[i] = (high * square_mod % mod + middle * base_mod % mod + low) % mod;
+  }
+  return result;
+}
+
+/**
+ * Multiplies by several NTT-friendly primes and restores coefficients by
+ * modulo with Garner's algorithm: x = a_0 + a_1 p_0 + a_2 p_0 p_1 + ...
+ */
+inline std::vector<int64_t> multiply_crt(const std::vector<int64_t> &lhs,
+                                         const std::vector<int64_t> &rhs,
+                                         int64_t mod) {
+  // Number of primes is enough to hold (mod - 1)^2 * min(|lhs|, |rhs|).
+  long double bits = 2 * std::log2(static_cast<long double>(mod)) +
+                     std::log2(static_cast<long double>(std::min(lhs.size(), rhs.size())));
+  auto capacity = [](size_t count) {
+    long double result = 0;
+    for (size_t i = 0; i < count; ++i) result += std::log2(static_cast<long double>(kCrtPrimes[i]));
+    return result;
+  };
+
+  const size_t primes = std::size(kCrtPrimes);
+  size_t count = 3;
+  while (count < primes && capacity(count) <= bits + 1) {
+    ++count;
+  }
+  assert(capacity(count) > bits + 1);
+
+  std::vector<std::vector<uint64_t>> residues;
+  residues.push_back(multiply_by_prime<kCrtPrimes[0]>(lhs, rhs));
+  residues.push_back(multiply_by_prime<kCrtPrimes[1]>(lhs, rhs));
+  residues.push_back(multiply_by_prime<kCrtPrimes[2]>(lhs, rhs));
+  if (count > 3) residues.push_back(multiply_by_prime<kCrtPrimes[3]>(lhs, rhs));
+  if (count > 4) residues.push_back(multiply_by_prime<kCrtPrimes[4]>(lhs, rhs));
+  if (count > 5) residues.push_back(multiply_by_prime<kCrtPrimes[5]>(lhs, rhs));
+
+  // inverses[i][j] = p_j^-1 mod p_i for j < i.
+  std::vector<std::vector<uint64_t>> inverses(count, std::vector<uint64_t>(count));
+  for (size_t i = 0; i < count; ++i) {
+    for (size_t j = 0; j < i; ++j) {
+      inverses[i][j] = pow_mod(kCrtPrimes[j] % kCrtPrimes[i], kCrtPrimes[i] - 2, kCrtPrimes[i]);
+    }
+  }
+
+  const auto target = static_cast<uint64_t>(mod);
+  std::vector<int64_t> result(residues[0].size());
+  std::vector<uint64_t> digits(count);
+  for (size_t k = 0; k < result.size(); ++k) {
+    uint64_t value = 0, prefix = 1 % target;
+    for (size_t i = 0; i < count; ++i) {
+      uint64_t digit = residues[i][k];
+      for (size_t j = 0; j < i; ++j) {
+        digit = (digit + kCrtPrimes[i] - digits[j] % kCrtPrimes[i]) * inverses[i][j] % kCrtPrimes[i];
+      }
+      digits[i] = digit;
+      value = (value + mul_mod(digit, prefix, target)) % target;
+      prefix = mul_mod(prefix, kCrtPrimes[i] % target, target);
+    }
+    result[k] = static_cast<int64_t>(value);
+  }
+  return result;
+}
+
+}  // namespace detail
+
+/**
+ * Multiplies sequences of residues in [0, mod) by any modulo below 2^62.
+ * Moduli below 2^31 use split transform of doubles while it's exact for
+ * given sizes, everything else goes through three to six NTT-friendly
+ * primes and CRT.
+ */
+inline std::vector<int64_t> multiply_mod(const std::vector<int64_t> &lhs,
+                                         const std::vector<int64_t> &rhs,
+                                         int64_t mod) {
+  assert(mod > 0 && mod < (int64_t{1} << 62));
+  if (lhs.empty() || rhs.empty()) {
+    return {};
+  }
+
+  if (mod < (int64_t{1} << 31) && detail::split_is_exact(mod, lhs.size(), rhs.size())) {
+    return detail::multiply_split(lhs, rhs, mod);
+  }
+  return detail::multiply_crt(lhs, rhs, mod);
+}
+
+/**
+ * Multiplies sequences of any Modular-like type: NTT-friendly prime moduli
+ * go to plain NTT over T, all the other ones go to multiply_mod.
+ */
+template <class T>
+std::vector<T> multiply_modular(const std::vector<T> &lhs, const std::vector<T> &rhs) {
+  if (lhs.empty() || rhs.empty()) {
+    return {};
+  }
+
+  const auto mod = static_cast<int64_t>(-T(1)) + 1;
+  const size_t result_size = lhs.size() + rhs.size() - 1;
+  // NTT by composite compile-time modulo isn't even instantiated.
+  if constexpr (detail::may_use_ntt<T>()) {
+    if (detail::use_ntt<T>(detail::transform_size(result_size))) {
+      auto result = multiply(lhs, rhs);
+      result.resize(result_size);
+      return result;
+    }
+  }
+
+  auto to_residues = [](const std::vector<T> &values) {
+    std::vector<int64_t> result(values.size());
+    for (size_t i = 0; i < values.size(); ++i) result[i] = static_cast<int64_t>(values[i]);
+    return result;
+  };
+
+  auto product = multiply_mod(to_residues(lhs), to_residues(rhs), mod);
+  return std::vector<T>(product.begin(), product.end());
+}
+
+}  // namespace fft
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include <algebra/modular.hpp>
+#include <algebra/montgomery.hpp>
+
+namespace fft {
+
+namespace detail {
+
+constexpr uint64_t mul_mod(uint64_t lhs, uint64_t rhs, uint64_t mod) {
+  return static_cast<uint64_t>(static_cast<unsigned __int128>(lhs) * rhs % mod);
+}
+
+constexpr uint64_t pow_mod(uint64_t base, uint64_t exponent, uint64_t mod) {
+  uint64_t result = 1 % mod;
+  for (; exponent; exponent >>= 1, base = mul_mod(base, base, mod)) {
+    if (exponent & 1) result = mul_mod(result, base, mod);
+  }
+  return result;
+}
+
+// Deterministic Miller-Rabin for all 64-bit numbers.
+constexpr bool is_prime(uint64_t number) {
+  if (number < 2) return false;
+  for (uint64_t prime : {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) {
+    if (number % prime == 0) return number == prime;
+  }
+
+  int shift = __builtin_ctzll(number - 1);
+  uint64_t odd = (number - 1) >> shift;
+  for (uint64_t witness : {2, 325, 9375, 28178, 450775, 9780504, 1795265022}) {
+    uint64_t x = pow_mod(witness % number, odd, number);
+    if (x == 0 || x == 1 || x == number - 1) continue;
+
+    bool composite = true;
+    for (int step = 1; step < shift && composite; ++step) {
+      x = mul_mod(x, x, number);
+      composite = x != number - 1;
+    }
+    if (composite) return false;
+  }
+  return true;
+}
+
+// Smallest primitive root of prime modulo, odd part of mod - 1 is factored by trial division.
+constexpr uint64_t primitive_root(uint64_t mod) {
+  if (mod == 2) return 1;
+
+  uint64_t divisors[64] = {2};
+  size_t count = 1;
+  uint64_t rest = (mod - 1) >> __builtin_ctzll(mod - 1);
+  for (uint64_t div = 3; div * div <= rest; div += 2) {
+    if (rest % div == 0) {
+      divisors[count++] = div;
+      while (rest % div == 0) rest /= div;
+    }
+  }
+  if (rest > 1) divisors[count++] = rest;
+
+  for (uint64_t candidate = 2;; ++candidate) {
+    bool is_primitive = true;
+    for (size_t i = 0; i < count && is_primitive; ++i) {
+      is_primitive = pow_mod(candidate, (mod - 1) / divisors[i], mod) != 1;
+    }
+    if (is_primitive) return candidate;
+  }
+}
+
+}  // namespace detail
+
+/**
+ * Everything NTT by prime modulo needs, computed at compile time: primitive
+ * root, largest power of two transform size 2^kMaxLog dividing mod - 1, and
+ * kRoots[log] (kInverseRoots[log]) of order exactly 2^log for log <= kMaxLog.
+ * Moduli that are not prime are rejected by static_assert.
+ */
+template <int64_t mod>
+struct ntt_traits {
+  static_assert(mod > 2 && detail::is_prime(mod), "NTT requires odd prime modulo");
+
+  static constexpr uint64_t kMod = mod;
+  static constexpr int kMaxLog = __builtin_ctzll(kMod - 1);
+  static constexpr size_t kMaxSize = size_t{1} << kMaxLog;
+  static constexpr int64_t kPrimitiveRoot = detail::primitive_root(kMod);
+
+  static constexpr std::array<int64_t, 64> Roots(bool inverse) {
+    std::array<int64_t, 64> result{};
+    uint64_t root = detail::pow_mod(kPrimitiveRoot, (kMod - 1) >> kMaxLog, kMod);
+    if (inverse) root = detail::pow_mod(root, kMod - 2, kMod);
+    for (int log = kMaxLog; log >= 0; --log) {
+      result[log] = static_cast<int64_t>(root);
+      root = detail::mul_mod(root, root, kMod);
+    }
+    return result;
+  }
+
+  static constexpr std::array<int64_t, 64> kRoots = Roots(false);
+  static constexpr std::array<int64_t, 64> kInverseRoots = Roots(true);
+};
+
+/**
+ * static_modulo<T>::value is compile-time modulo of Z<mod> and
+ * MontgomeryZ<mod>, it's zero for residues with modulo chosen at runtime.
+ */
+template <class T>
+struct static_modulo : std::integral_constant<int64_t, 0> {};
+
+template <class Integer, Integer mod>
+struct static_modulo<Modular<std::integral_constant<Integer, mod>>>
+    : std::integral_constant<int64_t, mod> {};
+
+template <class Integer, Integer mod>
+struct static_modulo<MontgomeryModular<std::integral_constant<Integer, mod>>>
+    : std::integral_constant<int64_t, mod> {};
+
+}  // namespace fft
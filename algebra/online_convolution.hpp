@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <algebra/convolution.hpp>
+#include <algebra/fft.hpp>
+#include <algebra/modular.hpp>
+#include <algebra/multiply_mod.hpp>
+
+namespace convolution {
+
+/**
+ * OnlineConvolution takes f[i] and g[i] one by one and returns (f * g)[i]
+ * right away, so that f[i + 1] might depend on it, in amortized
+ * O(log^2 n) per element (relaxed multiplication).
+ *
+ * Products f[a] g[b] with a or b equal to zero are added directly, all the
+ * others are split into blocks [s, 2s) x [j, j + s) and mirrored ones for
+ * powers of two s and multiples j >= s of s. Such block is multiplied at
+ * step j + s - 1, when both ranges are known, and adds to indices from
+ * j + s on, which are not returned yet.
+ *
+ * Every block of size s has f[s, 2s) or g[s, 2s) as one of the operands,
+ * so for NTT-friendly moduli their spectra are kept, and both blocks at a
+ * step are summed in frequency domain: that's three transforms per step
+ * and level instead of six. Transform buffers are reused by all blocks.
+ */
+template <class T>
+class OnlineConvolution {
+ public:
+  size_t size() const { return f_.size(); }
+
+  // Takes f[i] and g[i] for i = size(), returns (f * g)[i].
+  T Push(const T &f, const T &g) {
+    const size_t i = f_.size();
+    f_.push_back(f), g_.push_back(g);
+    if (h_.size() < 2 * i + 2) {
+      h_.resize(2 * i + 2, T(0));
+    }
+
+    h_[i] += f_[i] * g_[0];
+    if (i > 0) {
+      h_[i] += f_[0] * g_[i];
+    }
+    for (size_t s = 1; (i + 1) % s == 0 && i + 1 >= 2 * s; s *= 2) {
+      AddBlocks(s, i + 1 - s);
+    }
+    return h_[i];
+  }
+
+ private:
+  // Adds f[s, 2s) * g[j, j + s) and, for j != s, f[j, j + s) * g[s, 2s) to h.
+  void AddBlocks(size_t s, size_t j) {
+    T *out = h_.data() + s + j;
+    if (s <= thresholds<T>::kSchoolbook) {
+      for (size_t a = 0; a < s; ++a) {
+        for (size_t b = 0; b < s; ++b) {
+          out[a + b] += f_[s + a] * g_[j + b];
+          if (j != s) out[a + b] += f_[j + a] * g_[s + b];
+        }
+      }
+      return;
+    }
+
+    if constexpr (is_modular<T>::value && fft::detail::may_use_ntt<T>()) {
+      if (fft::detail::use_ntt<T>(2 * s)) {
+        AddBlocksByNtt(s, j, out);
+        return;
+      }
+    }
+
+    auto add = [&](const std::vector<T> &product) {
+      for (size_t k = 0; k < product.size(); ++k) out[k] += product[k];
+    };
+    add(multiply(std::vector<T>(f_.begin() + s, f_.begin() + 2 * s),
+                 std::vector<T>(g_.begin() + j, g_.begin() + j + s)));
+    if (j != s) {
+      add(multiply(std::vector<T>(f_.begin() + j, f_.begin() + j + s),
+                   std::vector<T>(g_.begin() + s, g_.begin() + 2 * s)));
+    }
+  }
+
+  void AddBlocksByNtt(size_t s, size_t j, T *out) {
+    const size_t size = 2 * s, log = __builtin_ctzll(s);
+    const auto &transform = fft::plan<T>(size);
+
+    // Spectra of f[s, 2s) and g[s, 2s) are built by the first block of level.
+    if (spectra_.size() <= log) {
+      spectra_.resize(log + 1);
+    }
+    auto &[f_spectrum, g_spectrum] = spectra_[log];
+    if (f_spectrum.empty()) {
+      Load(f_spectrum, f_, s, size), Load(g_spectrum, g_, s, size);
+      transform.Forward(f_spectrum.begin(), f_spectrum.end());
+      transform.Forward(g_spectrum.begin(), g_spectrum.end());
+    }
+
+    Load(lhs_, g_, j, size);
+    transform.Forward(lhs_.begin(), lhs_.end());
+    batch_kernels<T>::Multiply(lhs_.data(), lhs_.data(), f_spectrum.data(), size);
+    if (j != s) {
+      Load(rhs_, f_, j, size);
+      transform.Forward(rhs_.begin(), rhs_.end());
+      batch_kernels<T>::Multiply(rhs_.data(), rhs_.data(), g_spectrum.data(), size);
+      batch_kernels<T>::Add(lhs_.data(), lhs_.data(), rhs_.data(), size);
+    }
+    transform.Inverse(lhs_.begin(), lhs_.end());
+
+    for (size_t k = 0; k + 1 < size; ++k) {
+      out[k] += lhs_[k];
+    }
+  }
+
+  // buffer <- values[begin, begin + size / 2) padded by zeros up to size.
+  static void Load(std::vector<T> &buffer, const std::vector<T> &values, size_t begin, size_t size) {
+    buffer.resize(size);
+    std::copy(values.begin() + begin, values.begin() + begin + size / 2, buffer.begin());
+    std::fill(buffer.begin() + size / 2, buffer.end(), T(0));
+  }
+
+  std::vector<T> f_, g_, h_;
+  std::vector<std::pair<std::vector<T>, std::vector<T>>> spectra_;
+  std::vector<T> lhs_, rhs_;
+};
+
+}  // namespace convolution
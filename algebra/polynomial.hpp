@@ -1,9 +1,13 @@
 #pragma once
 
-#include <complex>
+#include <algorithm>
+#include <cassert>
+#include <utility>
 #include <vector>
 
-#include <algebra/fft.hpp>
+#include <algebra/bin_pow.hpp>
+#include <algebra/convolution.hpp>
+#include <algebra/modular.hpp>
 
 template <class T>
 class Polynomial {
@@ -17,7 +21,7 @@ class Polynomial {
   {}
 
   size_t degree() const { return coefficients_.size(); }
-  void resize(size_t degree) const { coefficients_.resize(degree); }
+  void resize(size_t degree) { coefficients_.resize(degree); }
 
   auto &operator[](size_t pow) { return coefficients_[pow]; }
   const auto &operator[](size_t pow) const { return coefficients_[pow]; }
@@ -33,34 +37,273 @@ class Polynomial {
 
   Polynomial &operator+=(const Polynomial &rhs);
   Polynomial &operator-=(const Polynomial &rhs);
+  Polynomial &operator*=(const T &scalar);
+
+  Polynomial Truncated(size_t size) const;
+  Polynomial Reversed() const;
+  Polynomial Derivative() const;
+  Polynomial Integral() const;
+
+  // Removes trailing zero coefficients.
+  Polynomial &Trim();
+
+  /**
+   * Formal power series operations, all of them return first `size`
+   * coefficients and take O(size log size) by Newton's doubling, hence T
+   * should be a field with fast multiplication, e.g. Z<998'244'353>.
+   */
+
+  // Requires invertible (*this)[0].
+  Polynomial Inverse(size_t size) const;
+  // Requires (*this)[0] == 1.
+  Polynomial Log(size_t size) const;
+  // Requires (*this)[0] == 0.
+  Polynomial Exp(size_t size) const;
+  // Requires (*this)[0] == 1, returns root with constant term 1.
+  Polynomial Sqrt(size_t size) const;
+  // Requires exponent >= 0.
+  Polynomial Pow(int64_t exponent, size_t size) const;
+
+  /**
+   * Returns quotient and remainder of division by rhs with nonzero leading
+   * coefficient, remainder has less than rhs.degree() coefficients.
+   */
+  std::pair<Polynomial, Polynomial> DivMod(const Polynomial &rhs) const;
 
  private:
   template <class U>
   friend Polynomial<U> operator*(const Polynomial<U> &lhs, const Polynomial<U> &rhs);
 
+  // Integer as coefficient, modular ones are reduced by their modulo explicitly.
+  static T Scalar(int64_t value);
+
   std::vector<T> coefficients_;
 };
 
+// Polynomial(size_t) is a size, so neutral element is built explicitly.
+template <class T>
+struct multiplicative_identity<Polynomial<T>> {
+  static constexpr bool kDefined = true;
+
+  static Polynomial<T> Of(const Polynomial<T> & /*value*/) { return Polynomial<T>{T(1)}; }
+};
+
+/**
+ * Multiplies polynomials via convolution::multiply: schoolbook, Karatsuba
+ * or transforms depending on sizes. Modular coefficients are multiplied
+ * exactly, integers as well while coefficients fit into int64_t, all the
+ * other types go through complex transform rounded to the nearest integer.
+ */
 template <class T>
 Polynomial<T> operator*(const Polynomial<T> &lhs, const Polynomial<T> &rhs) {
-  using Num = std::complex<long double>;
-  auto lhs_coefficients = std::vector<Num>(lhs.coefficients_.begin(), lhs.coefficients_.end());
-  auto rhs_coefficients = std::vector<Num>(rhs.coefficients_.begin(), rhs.coefficients_.end());
+  auto result = convolution::multiply(lhs.coefficients_, rhs.coefficients_);
+  return Polynomial<T>(result.begin(), result.end());
+}
 
-  auto result = fft::multiply(lhs_coefficients, rhs_coefficients);
-  auto result_polynomial = Polynomial<T>(result.size());
+template <class T>
+Polynomial<T> &Polynomial<T>::operator+=(const Polynomial &rhs) {
+  if (degree() < rhs.degree()) {
+    resize(rhs.degree());
+  }
+  for (size_t pow = 0; pow < rhs.degree(); ++pow) {
+    coefficients_[pow] += rhs[pow];
+  }
+  return *this;
+}
 
-  for (size_t i = 0; i < result.size(); ++i) {
-    result_polynomial[i] = llround(result[i].real());
+template <class T>
+Polynomial<T> &Polynomial<T>::operator-=(const Polynomial &rhs) {
+  if (degree() < rhs.degree()) {
+    resize(rhs.degree());
   }
+  for (size_t pow = 0; pow < rhs.degree(); ++pow) {
+    coefficients_[pow] -= rhs[pow];
+  }
+  return *this;
+}
 
-  return result_polynomial;
+template <class T>
+Polynomial<T> &Polynomial<T>::operator*=(const T &scalar) {
+  for (auto &coeff : coefficients_) {
+    coeff *= scalar;
+  }
+  return *this;
 }
 
 template <class T>
-Polynomial<T> &Polynomial<T>::operator+=(const Polynomial &rhs) {
-  for (size_t pow = 0; pow < std::min(degree(), rhs.degree()); ++pow) {
-    coefficients_[pow] += rhs[pow];
+Polynomial<T> operator+(Polynomial<T> lhs, const Polynomial<T> &rhs) { return lhs += rhs; }
+
+template <class T>
+Polynomial<T> operator-(Polynomial<T> lhs, const Polynomial<T> &rhs) { return lhs -= rhs; }
+
+template <class T>
+Polynomial<T> operator*(Polynomial<T> lhs, const T &scalar) { return lhs *= scalar; }
+
+template <class T>
+Polynomial<T> operator/(const Polynomial<T> &lhs, const Polynomial<T> &rhs) {
+  return lhs.DivMod(rhs).first;
+}
+
+template <class T>
+Polynomial<T> operator%(const Polynomial<T> &lhs, const Polynomial<T> &rhs) {
+  return lhs.DivMod(rhs).second;
+}
+
+template <class T>
+Polynomial<T> Polynomial<T>::Truncated(size_t size) const {
+  auto result = Polynomial(coefficients_.begin(),
+                           coefficients_.begin() + std::min(size, degree()));
+  result.resize(size);
+  return result;
+}
+
+template <class T>
+Polynomial<T> Polynomial<T>::Reversed() const {
+  return Polynomial(coefficients_.rbegin(), coefficients_.rend());
+}
+
+template <class T>
+Polynomial<T> Polynomial<T>::Derivative() const {
+  auto result = Polynomial(degree() ? degree() - 1 : 0);
+  for (size_t pow = 1; pow < degree(); ++pow) {
+    result[pow - 1] = coefficients_[pow] * T(static_cast<int64_t>(pow));
+  }
+  return result;
+}
+
+template <class T>
+Polynomial<T> Polynomial<T>::Integral() const {
+  std::vector<T> inverses(degree());
+  for (size_t pow = 0; pow < degree(); ++pow) {
+    inverses[pow] = T(static_cast<int64_t>(pow + 1));
+  }
+  batch::Inverse(inverses, inverses);
+
+  auto result = Polynomial(degree() + 1);
+  for (size_t pow = 0; pow < degree(); ++pow) {
+    result[pow + 1] = coefficients_[pow] * inverses[pow];
+  }
+  return result;
+}
+
+template <class T>
+Polynomial<T> &Polynomial<T>::Trim() {
+  while (!coefficients_.empty() && coefficients_.back() == T(0)) {
+    coefficients_.pop_back();
   }
   return *this;
 }
+
+// g <- g * (2 - f * g) doubles number of correct coefficients of 1 / f.
+template <class T>
+Polynomial<T> Polynomial<T>::Inverse(size_t size) const {
+  auto result = Polynomial{T(1) / coefficients_[0]};
+  for (size_t length = 1; length < size; length *= 2) {
+    auto error = (Truncated(2 * length) * result).Truncated(2 * length);
+    error *= T(-1);
+    error[0] += T(2);
+    result = (result * error).Truncated(2 * length);
+  }
+  return result.Truncated(size);
+}
+
+template <class T>
+Polynomial<T> Polynomial<T>::Log(size_t size) const {
+  if (!size) {
+    return Polynomial();
+  }
+  auto quotient = Truncated(size).Derivative() * Inverse(size);
+  return quotient.Truncated(size - 1).Integral();
+}
+
+// g <- g * (1 - log g + f) doubles number of correct coefficients of exp f.
+template <class T>
+Polynomial<T> Polynomial<T>::Exp(size_t size) const {
+  auto result = Polynomial{T(1)};
+  for (size_t length = 1; length < size; length *= 2) {
+    auto step = Truncated(2 * length) - result.Log(2 * length);
+    step[0] += T(1);
+    result = (result * step).Truncated(2 * length);
+  }
+  return result.Truncated(size);
+}
+
+// g <- (g + f / g) / 2 doubles number of correct coefficients of sqrt f.
+template <class T>
+Polynomial<T> Polynomial<T>::Sqrt(size_t size) const {
+  auto result = Polynomial{T(1)};
+  const T half = T(1) / T(2);
+  for (size_t length = 1; length < size; length *= 2) {
+    auto quotient = (Truncated(2 * length) * result.Inverse(2 * length)).Truncated(2 * length);
+    result = (result + quotient) * half;
+  }
+  return result.Truncated(size);
+}
+
+/**
+ * Computes f^k as (c x^t)^k * exp(k log(f / (c x^t))) for lowest nonzero
+ * term c x^t of f.
+ */
+template <class T>
+T Polynomial<T>::Scalar(int64_t value) {
+  if constexpr (is_modular<T>::value) {
+    const auto mod = static_cast<int64_t>(-T(1)) + 1;
+    return T((value % mod + mod) % mod);
+  } else {
+    return T(value);
+  }
+}
+
+template <class T>
+Polynomial<T> Polynomial<T>::Pow(int64_t exponent, size_t size) const {
+  assert(exponent >= 0);
+  auto result = Polynomial(size);
+  if (!size) {
+    return result;
+  }
+  if (exponent == 0) {
+    result[0] = T(1);
+    return result;
+  }
+
+  size_t shift = 0;
+  while (shift < degree() && coefficients_[shift] == T(0)) {
+    ++shift;
+  }
+  if (shift == degree() || shift > (size - 1) / static_cast<uint64_t>(exponent)) {
+    return result;
+  }
+
+  size_t tail = size - shift * exponent;
+  T lowest = coefficients_[shift], inverse = T(1) / lowest;
+
+  auto normalized = Polynomial(coefficients_.begin() + shift, coefficients_.end());
+  normalized *= inverse;
+
+  auto power = normalized.Log(tail) * Scalar(exponent);
+  power = power.Exp(tail) * BinPow(lowest, exponent);
+
+  for (size_t pow = 0; pow < tail; ++pow) {
+    result[pow + shift * exponent] = power[pow];
+  }
+  return result;
+}
+
+template <class T>
+std::pair<Polynomial<T>, Polynomial<T>> Polynomial<T>::DivMod(const Polynomial &rhs) const {
+  auto divisor = rhs;
+  divisor.Trim();
+  assert(divisor.degree() > 0);
+
+  if (degree() < divisor.degree()) {
+    return {Polynomial(), *this};
+  }
+
+  size_t size = degree() - divisor.degree() + 1;
+  auto quotient = (Reversed().Truncated(size) * divisor.Reversed().Inverse(size))
+      .Truncated(size)
+      .Reversed();
+
+  auto remainder = (*this - divisor * quotient).Truncated(divisor.degree() - 1);
+  return {quotient, remainder};
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include <algebra/fft.hpp>
+
+namespace fft {
+
+namespace detail {
+
+/**
+ * Complex transform over doubles stored as two separate arrays of real and
+ * imaginary parts, hence every butterfly layer is a plain loop over four
+ * arrays that's vectorized with AVX2 whenever it's available.
+ *
+ * Twiddles are stored the same way as in FftPlan, each top-layer one is
+ * computed directly by cos/sin in long double.
+ */
+class SplitPlan {
+ public:
+  explicit SplitPlan(size_t size)
+      : reversed_(size),
+        roots_re_(std::max<size_t>(size, 2), 1),
+        roots_im_(std::max<size_t>(size, 2), 0) {
+    assert(size && !(size & (size - 1)));
+    int logs = __builtin_ctzll(size);
+
+    for (size_t index = 1; index < size; ++index) {
+      reversed_[index] = (reversed_[index >> 1] >> 1) | ((index & 1) << (logs - 1));
+    }
+
+    const long double pi = std::acos(-1.0L);
+    for (size_t half = size / 2, j = 0; j < half; ++j) {
+      roots_re_[half + j] = static_cast<double>(std::cos(pi * j / half));
+      roots_im_[half + j] = static_cast<double>(std::sin(pi * j / half));
+    }
+    for (size_t bit = size / 4; bit > 0; bit /= 2) {
+      for (size_t j = 0; j < bit; ++j) {
+        roots_re_[bit + j] = roots_re_[2 * bit + 2 * j];
+        roots_im_[bit + j] = roots_im_[2 * bit + 2 * j];
+      }
+    }
+  }
+
+  size_t size() const { return reversed_.size(); }
+
+  void Forward(double *re, double *im) const {
+    const size_t size = this->size();
+    for (size_t index = 0; index < size; ++index) {
+      if (reversed_[index] < index) {
+        std::swap(re[index], re[reversed_[index]]);
+        std::swap(im[index], im[reversed_[index]]);
+      }
+    }
+
+    for (size_t bit = 1; bit < size; bit <<= 1) {
+      for (size_t start = 0; start < size; start += 2 * bit) {
+        Butterflies(re + start, im + start, bit);
+      }
+    }
+  }
+
+  void Inverse(double *re, double *im) const {
+    Forward(re, im);
+    std::reverse(re + 1, re + size());
+    std::reverse(im + 1, im + size());
+
+    const double inv_size = 1.0 / static_cast<double>(size());
+    for (size_t index = 0; index < size(); ++index) {
+      re[index] *= inv_size, im[index] *= inv_size;
+    }
+  }
+
+ private:
+  void Butterflies(double *re, double *im, size_t bit) const {
+    const double *w_re = roots_re_.data() + bit, *w_im = roots_im_.data() + bit;
+    size_t j = 0;
+
+#ifdef __AVX2__
+    for (; j + 4 <= bit; j += 4) {
+      __m256d u_re = _mm256_loadu_pd(re + j), u_im = _mm256_loadu_pd(im + j);
+      __m256d v_re = _mm256_loadu_pd(re + bit + j), v_im = _mm256_loadu_pd(im + bit + j);
+      __m256d t_re = _mm256_loadu_pd(w_re + j), t_im = _mm256_loadu_pd(w_im + j);
+
+      __m256d p_re = _mm256_sub_pd(_mm256_mul_pd(v_re, t_re), _mm256_mul_pd(v_im, t_im));
+      __m256d p_im = _mm256_add_pd(_mm256_mul_pd(v_re, t_im), _mm256_mul_pd(v_im, t_re));
+
+      _mm256_storeu_pd(re + j, _mm256_add_pd(u_re, p_re));
+      _mm256_storeu_pd(im + j, _mm256_add_pd(u_im, p_im));
+      _mm256_storeu_pd(re + bit + j, _mm256_sub_pd(u_re, p_re));
+      _mm256_storeu_pd(im + bit + j, _mm256_sub_pd(u_im, p_im));
+    }
+#endif
+
+    for (; j < bit; ++j) {
+      double p_re = re[bit + j] * w_re[j] - im[bit + j] * w_im[j];
+      double p_im = re[bit + j] * w_im[j] + im[bit + j] * w_re[j];
+      double u_re = re[j], u_im = im[j];
+      re[j] = u_re + p_re, im[j] = u_im + p_im;
+      re[bit + j] = u_re - p_re, im[bit + j] = u_im - p_im;
+    }
+  }
+
+  std::vector<size_t> reversed_;
+  std::vector<double> roots_re_, roots_im_;
+};
+
+inline const SplitPlan &split_plan(size_t size) {
+  thread_local std::vector<std::unique_ptr<SplitPlan>> plans;
+
+  size_t log = __builtin_ctzll(size);
+  if (plans.size() <= log) {
+    plans.resize(log + 1);
+  }
+  if (!plans[log]) {
+    plans[log] = std::make_unique<SplitPlan>(size);
+  }
+  return *plans[log];
+}
+
+/**
+ * Double transform keeps product exact until coefficients of result times
+ * log of transform size stay well below 2^53, all the products exceeding this
+ * bound are multiplied in long double instead.
+ */
+constexpr long double kExactBound = 1LL << 47;
+
+}  // namespace detail
+
+/**
+ * Multiplies integer sequences with single complex transform of doubles:
+ * lhs goes to real parts, rhs goes to imaginary ones, and both spectra are
+ * recovered from P[k] and conj(P[-k]) before inverse transform.
+ */
+inline std::vector<int64_t> multiply_integer(const std::vector<int64_t> &lhs,
+                                             const std::vector<int64_t> &rhs) {
+  if (lhs.empty() || rhs.empty()) {
+    return {};
+  }
+
+  const size_t result_size = lhs.size() + rhs.size() - 1;
+  const size_t size = detail::transform_size(result_size);
+
+  auto max_abs = [](const std::vector<int64_t> &xs) {
+    long double result = 0;
+    for (auto x : xs) result = std::max(result, std::abs(static_cast<long double>(x)));
+    return result;
+  };
+
+  long double magnitude = max_abs(lhs) * max_abs(rhs) * std::min(lhs.size(), rhs.size());
+  if (magnitude * (__builtin_ctzll(size) + 1) >= detail::kExactBound) {
+    using Num = std::complex<long double>;
+    auto product = multiply(std::vector<Num>(lhs.begin(), lhs.end()),
+                            std::vector<Num>(rhs.begin(), rhs.end()));
+
+    std::vector<int64_t> result(result_size);
+    for (size_t i = 0; i < result_size; ++i) {
+      result[i] = llroundl(product[i].real());
+    }
+    return result;
+  }
+
+  std::vector<double> re(size), im(size);
+  std::copy(lhs.begin(), lhs.end(), re.begin());
+  std::copy(rhs.begin(), rhs.end(), im.begin());
+
+  const auto &transform = detail::split_plan(size);
+  transform.Forward(re.data(), im.data());
+
+  // x = P[k] + conj(P[-k]) = 2 * L[k], y = P[k] - conj(P[-k]) = 2i * R[k],
+  // so L[k] * R[k] = x * y / 4i.
+  std::vector<double> out_re(size), out_im(size);
+  for (size_t k = 0; k < size; ++k) {
+    size_t j = (size - k) & (size - 1);
+    double x_re = re[k] + re[j], x_im = im[k] - im[j];
+    double y_re = re[k] - re[j], y_im = im[k] + im[j];
+
+    double prod_re = x_re * y_re - x_im * y_im;
+    double prod_im = x_re * y_im + x_im * y_re;
+    out_re[k] = prod_im / 4, out_im[k] = -prod_re / 4;
+  }
+
+  transform.Inverse(out_re.data(), out_im.data());
+
+  std::vector<int64_t> result(result_size);
+  for (size_t i = 0; i < result_size; ++i) {
+    result[i] = llround(out_re[i]);
+  }
+  return result;
+}
+
+}  // namespace fft
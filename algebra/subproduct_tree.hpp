@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include <algebra/polynomial.hpp>
+
+/**
+ * SubproductTree keeps products of (x - x_i) over all segment-tree nodes of
+ * given points, so that multipoint evaluation and interpolation on them take
+ * O(n log^2 n) each. Tree is built once and might be reused for any number
+ * of polynomials evaluated at the same points.
+ */
+template <class T>
+class SubproductTree {
+ public:
+  explicit SubproductTree(std::vector<T> points)
+      : points_(std::move(points)),
+        tree_(4 * std::max<size_t>(points_.size(), 1)) {
+    if (!points_.empty()) {
+      Build(1, 0, points_.size());
+    }
+  }
+
+  size_t size() const { return points_.size(); }
+  const std::vector<T> &points() const { return points_; }
+
+  // Returns product of (x - x_i) over all points.
+  const Polynomial<T> &Product() const { return tree_[1]; }
+
+  std::vector<T> Evaluate(const Polynomial<T> &polynomial) const {
+    std::vector<T> result(size());
+    if (!points_.empty()) {
+      Evaluate(1, 0, size(), polynomial % tree_[1], result);
+    }
+    return result;
+  }
+
+  /**
+   * Returns polynomial with less than size() coefficients that takes
+   * values[i] at points[i], points should be distinct.
+   */
+  Polynomial<T> Interpolate(const std::vector<T> &values) const {
+    assert(values.size() == size());
+    if (points_.empty()) {
+      return Polynomial<T>();
+    }
+
+    auto weights = Evaluate(tree_[1].Derivative());
+    batch::Inverse(weights, weights);
+    batch::Multiply(weights, weights, values);
+    return Combine(1, 0, size(), weights);
+  }
+
+ private:
+  // Below that size remainders are evaluated directly.
+  static constexpr size_t kNaiveSize = 32;
+
+  void Build(size_t node, size_t begin, size_t end) {
+    if (end - begin == 1) {
+      tree_[node] = Polynomial<T>{-points_[begin], T(1)};
+      return;
+    }
+    size_t mid = (begin + end) / 2;
+    Build(2 * node, begin, mid), Build(2 * node + 1, mid, end);
+    tree_[node] = tree_[2 * node] * tree_[2 * node + 1];
+  }
+
+  void Evaluate(size_t node, size_t begin, size_t end,
+                const Polynomial<T> &rest, std::vector<T> &result) const {
+    if (end - begin <= kNaiveSize) {
+      for (size_t i = begin; i < end; ++i) {
+        result[i] = rest(points_[i]);
+      }
+      return;
+    }
+    size_t mid = (begin + end) / 2;
+    Evaluate(2 * node, begin, mid, rest % tree_[2 * node], result);
+    Evaluate(2 * node + 1, mid, end, rest % tree_[2 * node + 1], result);
+  }
+
+  // Returns sum of weights[i] * prod_{j != i} (x - x_j) over node's segment.
+  Polynomial<T> Combine(size_t node, size_t begin, size_t end,
+                        const std::vector<T> &weights) const {
+    if (end - begin == 1) {
+      return Polynomial<T>{weights[begin]};
+    }
+    size_t mid = (begin + end) / 2;
+    return Combine(2 * node, begin, mid, weights) * tree_[2 * node + 1] +
+           Combine(2 * node + 1, mid, end, weights) * tree_[2 * node];
+  }
+
+  std::vector<T> points_;
+  std::vector<Polynomial<T>> tree_;
+};
+
+template <class T>
+std::vector<T> Evaluate(const Polynomial<T> &polynomial, std::vector<T> points) {
+  return SubproductTree<T>(std::move(points)).Evaluate(polynomial);
+}
+
+template <class T>
+Polynomial<T> Interpolate(std::vector<T> points, const std::vector<T> &values) {
+  return SubproductTree<T>(std::move(points)).Interpolate(values);
+}
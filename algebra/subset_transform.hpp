@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <algebra/modular.hpp>
+
+/**
+ * Transforms over subsets of n-bit masks, each of them takes O(n 2^n):
+ * Walsh-Hadamard for XOR convolution, zeta/Mobius over subsets for OR and
+ * over supersets for AND, and ranked zeta for subset convolution in
+ * O(n^2 2^n).
+ *
+ * Transforms are in place over vectors of power of two sizes. Layers are
+ * applied like FFT butterflies, each one of half-length `bit` processes
+ * contiguous halves [start, start + bit) and [start + bit, start + 2 bit)
+ * with batch_kernels<T>, so MontgomeryModular gets AVX2 kernels.
+ */
+namespace subset {
+
+namespace detail {
+
+// Calls func(lower, upper, bit) for halves of all the blocks of all the layers.
+template <class T, class Func>
+void butterflies(std::vector<T> &values, Func &&func) {
+  const size_t size = values.size();
+  assert(size && !(size & (size - 1)));
+  for (size_t bit = 1; bit < size; bit <<= 1) {
+    for (size_t start = 0; start < size; start += 2 * bit) {
+      func(values.data() + start, values.data() + start + bit, bit);
+    }
+  }
+}
+
+// values[i] /= size, integral values should be divisible by it.
+template <class T>
+void divide(std::vector<T> &values) {
+  if constexpr (std::is_integral_v<T>) {
+    for (auto &value : values) value /= static_cast<T>(values.size());
+  } else {
+    const T inverse = T(1) / T(static_cast<int64_t>(values.size()));
+    for (auto &value : values) value *= inverse;
+  }
+}
+
+}  // namespace detail
+
+// (lower, upper) <- (lower + upper, lower - upper) without scratch memory.
+template <class T>
+void hadamard(std::vector<T> &values) {
+  detail::butterflies(values, [](T *lower, T *upper, size_t bit) {
+    batch_kernels<T>::Subtract(upper, lower, upper, bit);
+    batch_kernels<T>::Add(lower, lower, lower, bit);
+    batch_kernels<T>::Subtract(lower, lower, upper, bit);
+  });
+}
+
+template <class T>
+void inverse_hadamard(std::vector<T> &values) {
+  hadamard(values);
+  detail::divide(values);
+}
+
+// values[mask] <- sum of values[sub] over all sub of mask.
+template <class T>
+void zeta_subsets(std::vector<T> &values) {
+  detail::butterflies(values, [](T *lower, T *upper, size_t bit) {
+    batch_kernels<T>::Add(upper, upper, lower, bit);
+  });
+}
+
+template <class T>
+void mobius_subsets(std::vector<T> &values) {
+  detail::butterflies(values, [](T *lower, T *upper, size_t bit) {
+    batch_kernels<T>::Subtract(upper, upper, lower, bit);
+  });
+}
+
+// values[mask] <- sum of values[super] over all super of mask.
+template <class T>
+void zeta_supersets(std::vector<T> &values) {
+  detail::butterflies(values, [](T *lower, T *upper, size_t bit) {
+    batch_kernels<T>::Add(lower, lower, upper, bit);
+  });
+}
+
+template <class T>
+void mobius_supersets(std::vector<T> &values) {
+  detail::butterflies(values, [](T *lower, T *upper, size_t bit) {
+    batch_kernels<T>::Subtract(lower, lower, upper, bit);
+  });
+}
+
+/**
+ * All the convolutions below take vectors of the same power of two size
+ * and return result[mask] = sum lhs[i] * rhs[j] over i, j combined into mask
+ * by corresponding operation.
+ */
+
+template <class T>
+std::vector<T> xor_multiply(std::vector<T> lhs, std::vector<T> rhs) {
+  assert(lhs.size() == rhs.size());
+  hadamard(lhs), hadamard(rhs);
+  batch_kernels<T>::Multiply(lhs.data(), lhs.data(), rhs.data(), lhs.size());
+  inverse_hadamard(lhs);
+  return lhs;
+}
+
+template <class T>
+std::vector<T> or_multiply(std::vector<T> lhs, std::vector<T> rhs) {
+  assert(lhs.size() == rhs.size());
+  zeta_subsets(lhs), zeta_subsets(rhs);
+  batch_kernels<T>::Multiply(lhs.data(), lhs.data(), rhs.data(), lhs.size());
+  mobius_subsets(lhs);
+  return lhs;
+}
+
+template <class T>
+std::vector<T> and_multiply(std::vector<T> lhs, std::vector<T> rhs) {
+  assert(lhs.size() == rhs.size());
+  zeta_supersets(lhs), zeta_supersets(rhs);
+  batch_kernels<T>::Multiply(lhs.data(), lhs.data(), rhs.data(), lhs.size());
+  mobius_supersets(lhs);
+  return lhs;
+}
+
+/**
+ * Subset convolution: result[mask] = sum lhs[i] * rhs[mask ^ i] over all
+ * i subset of mask. Values are split by popcount into n + 1 ranks, each
+ * rank is zeta transformed, ranks are multiplied as polynomials pointwise
+ * and only rank popcount(mask) of Mobius transformed product is kept.
+ */
+template <class T>
+std::vector<T> subset_multiply(const std::vector<T> &lhs, const std::vector<T> &rhs) {
+  assert(lhs.size() == rhs.size());
+  const size_t size = lhs.size();
+  const size_t bits = __builtin_ctzll(size);
+
+  auto ranked = [&](const std::vector<T> &values) {
+    std::vector<std::vector<T>> result(bits + 1, std::vector<T>(size, T(0)));
+    for (size_t mask = 0; mask < size; ++mask) {
+      result[__builtin_popcountll(mask)][mask] = values[mask];
+    }
+    for (auto &rank : result) zeta_subsets(rank);
+    return result;
+  };
+  auto lhs_ranks = ranked(lhs), rhs_ranks = ranked(rhs);
+
+  std::vector<T> product(size), result(size);
+  for (size_t rank = 0; rank <= bits; ++rank) {
+    std::fill(product.begin(), product.end(), T(0));
+    for (size_t i = 0; i <= rank; ++i) {
+      batch_kernels<T>::MultiplyAdd(product.data(), lhs_ranks[i].data(),
+                                    rhs_ranks[rank - i].data(), size);
+    }
+    mobius_subsets(product);
+    for (size_t mask = 0; mask < size; ++mask) {
+      if (static_cast<size_t>(__builtin_popcountll(mask)) == rank) {
+        result[mask] = product[mask];
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace subset
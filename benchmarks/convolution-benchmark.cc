@@ -0,0 +1,63 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <algebra/convolution.hpp>
+#include <algebra/modular.hpp>
+
+/**
+ * Measures all the kernels of convolution::multiply on balanced operands of
+ * growing sizes, crossovers of these timings give convolution::thresholds,
+ * and the last column is the dispatch itself.
+ */
+
+template <class Func>
+double Measure(Func &&func) {
+  using Clock = std::chrono::steady_clock;
+
+  size_t repetitions = 0;
+  auto start = Clock::now();
+  std::chrono::duration<double> elapsed{};
+  do {
+    func();
+    ++repetitions;
+    elapsed = Clock::now() - start;
+  } while (elapsed.count() < 0.05);
+
+  return elapsed.count() / repetitions * 1e6;
+}
+
+template <class T>
+void Benchmark(const char *name) {
+  std::mt19937 rnd(239);
+  std::cout << name << ", microseconds per product:\n"
+            << std::setw(8) << "size" << std::setw(14) << "schoolbook"
+            << std::setw(14) << "karatsuba" << std::setw(14) << "transform"
+            << std::setw(14) << "multiply" << "\n";
+
+  for (size_t size = 8; size <= 2048; size *= 2) {
+    std::vector<T> lhs(size), rhs(size);
+    for (auto &x : lhs) x = T(static_cast<int64_t>(rnd() % 1000));
+    for (auto &x : rhs) x = T(static_cast<int64_t>(rnd() % 1000));
+
+    // Results are accumulated, so that measured products aren't optimized away.
+    T checksum(0);
+    std::cout << std::setw(8) << size << std::fixed << std::setprecision(2)
+              << std::setw(14) << Measure([&] { checksum += convolution::schoolbook(lhs, rhs)[size]; })
+              << std::setw(14) << Measure([&] { checksum += convolution::karatsuba(lhs, rhs)[size]; })
+              << std::setw(14) << Measure([&] { checksum += convolution::transform(lhs, rhs)[size]; })
+              << std::setw(14) << Measure([&] { checksum += convolution::multiply(lhs, rhs)[size]; })
+              << "\n";
+    if (checksum == T(42)) std::cout << "";
+  }
+  std::cout << "\n";
+}
+
+int main() {
+  Benchmark<Z<998'244'353>>("Z<998'244'353>");
+  Benchmark<Z<1'000'000'007>>("Z<1'000'000'007>");
+  Benchmark<int64_t>("int64_t");
+}
@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <data-structures/eytzinger.hpp>
+
+/**
+ * Compares std::lower_bound over sorted array with single and batched
+ * Eytzinger lookups on random queries.
+ */
+
+template <class Func>
+double Measure(Func &&func) {
+  using Clock = std::chrono::steady_clock;
+
+  size_t repetitions = 0;
+  auto start = Clock::now();
+  std::chrono::duration<double> elapsed{};
+  do {
+    func();
+    ++repetitions;
+    elapsed = Clock::now() - start;
+  } while (elapsed.count() < 0.2);
+
+  return elapsed.count() / repetitions;
+}
+
+int main() {
+  std::mt19937_64 rnd(239);
+  const size_t kQueries = 1 << 20;
+
+  std::cout << "nanoseconds per lookup:\n"
+            << std::setw(10) << "size" << std::setw(14) << "lower_bound"
+            << std::setw(14) << "eytzinger" << std::setw(14) << "batched" << "\n";
+
+  for (size_t size = 1 << 10; size <= (1 << 24); size <<= 2) {
+    std::vector<int64_t> values(size), queries(kQueries);
+    for (auto &value : values) value = static_cast<int64_t>(rnd() >> 1);
+    for (auto &query : queries) query = static_cast<int64_t>(rnd() >> 1);
+    std::sort(values.begin(), values.end());
+    eytzinger::Eytzinger<int64_t> index(values);
+
+    size_t checksum = 0;
+    auto per_lookup = [&](double seconds) { return seconds / kQueries * 1e9; };
+    std::cout << std::setw(10) << size << std::fixed << std::setprecision(2)
+              << std::setw(14) << per_lookup(Measure([&] {
+                   for (auto query : queries) {
+                     checksum += std::lower_bound(values.begin(), values.end(), query) - values.begin();
+                   }
+                 }))
+              << std::setw(14) << per_lookup(Measure([&] {
+                   for (auto query : queries) checksum += index.LowerBound(query);
+                 }))
+              << std::setw(14) << per_lookup(Measure([&] {
+                   checksum += index.LowerBound(queries).back();
+                 }))
+              << "\n";
+    if (checksum == 42) std::cout << "";
+  }
+}
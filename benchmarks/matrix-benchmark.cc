@@ -0,0 +1,73 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <algebra/matrix.hpp>
+#include <algebra/modular.hpp>
+#include <algebra/montgomery.hpp>
+
+/**
+ * Compares blocked Matrix<T> product with naive one over vector<vector<T>>.
+ */
+
+template <class Func>
+double Measure(Func &&func) {
+  using Clock = std::chrono::steady_clock;
+
+  size_t repetitions = 0;
+  auto start = Clock::now();
+  std::chrono::duration<double> elapsed{};
+  do {
+    func();
+    ++repetitions;
+    elapsed = Clock::now() - start;
+  } while (elapsed.count() < 0.2);
+
+  return elapsed.count() / repetitions * 1e3;
+}
+
+template <class T>
+std::vector<std::vector<T>> NaiveMultiply(const std::vector<std::vector<T>> &lhs,
+                                          const std::vector<std::vector<T>> &rhs) {
+  std::vector<std::vector<T>> result(lhs.size(), std::vector<T>(rhs[0].size(), T(0)));
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    for (size_t k = 0; k < rhs.size(); ++k) {
+      for (size_t j = 0; j < rhs[0].size(); ++j) {
+        result[i][j] += lhs[i][k] * rhs[k][j];
+      }
+    }
+  }
+  return result;
+}
+
+template <class T>
+void Benchmark(const char *name) {
+  std::mt19937 rnd(239);
+  std::cout << name << ", milliseconds per product:\n"
+            << std::setw(8) << "size" << std::setw(14) << "naive" << std::setw(14) << "matrix" << "\n";
+
+  for (size_t size = 64; size <= 512; size *= 2) {
+    Matrix<T> lhs(size, size), rhs(size, size);
+    std::vector<std::vector<T>> naive_lhs(size, std::vector<T>(size)), naive_rhs = naive_lhs;
+    for (size_t i = 0; i < size; ++i) {
+      for (size_t j = 0; j < size; ++j) {
+        naive_lhs[i][j] = lhs[i][j] = T(static_cast<int64_t>(rnd() % 998'244'353));
+        naive_rhs[i][j] = rhs[i][j] = T(static_cast<int64_t>(rnd() % 998'244'353));
+      }
+    }
+
+    std::cout << std::setw(8) << size << std::fixed << std::setprecision(2)
+              << std::setw(14) << Measure([&] { NaiveMultiply(naive_lhs, naive_rhs); })
+              << std::setw(14) << Measure([&] { lhs * rhs; })
+              << "\n";
+  }
+  std::cout << "\n";
+}
+
+int main() {
+  Benchmark<Z<998'244'353>>("Z<998'244'353>");
+  Benchmark<MontgomeryZ<998'244'353>>("MontgomeryZ<998'244'353>");
+}
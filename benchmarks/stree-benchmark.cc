@@ -0,0 +1,105 @@
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <data-structures/segment-tree/bottom-up.hpp>
+#include <data-structures/segment-tree/segment-tree.hpp>
+
+/**
+ * Compares node storages of recursive segment_tree::STree and non-recursive
+ * BottomUpTree on random point updates and range folds of int64_t sums.
+ */
+
+struct SumData {
+  static auto Pure(int64_t value) { return value; }
+  static auto Merge(int64_t lhs, int64_t rhs) -> int64_t { return lhs + rhs; }
+};
+
+template <class T>
+struct Setter {
+  int index;
+  T value;
+
+  template <class Walker>
+  void set(Walker walker) {
+    if (walker.size() == 1) {
+      walker.Get() = Walker::Monoid::Pure(value);
+    } else {
+      set(index < walker.mid() ? walker.Left() : walker.Right());
+      walker.Update();
+    }
+  }
+};
+
+template <class Func>
+double Measure(Func &&func) {
+  using Clock = std::chrono::steady_clock;
+
+  size_t repetitions = 0;
+  auto start = Clock::now();
+  std::chrono::duration<double> elapsed{};
+  do {
+    func();
+    ++repetitions;
+    elapsed = Clock::now() - start;
+  } while (elapsed.count() < 0.2);
+
+  return elapsed.count() / repetitions;
+}
+
+struct Query {
+  int index, begin, end;
+  int64_t value;
+};
+
+template <template <class, class> class Storage>
+double PerQuery(const std::vector<int64_t> &values, const std::vector<Query> &queries, int64_t &checksum) {
+  auto stree = segment_tree::build<SumData, Storage>(values);
+  return Measure([&] {
+           for (auto &query : queries) {
+             Setter<int64_t>{query.index, query.value}.set(stree.Root());
+             checksum += stree.Fold(query.begin, query.end);
+           }
+         }) / queries.size() * 1e9;
+}
+
+double BottomUpPerQuery(const std::vector<int64_t> &values, const std::vector<Query> &queries, int64_t &checksum) {
+  segment_tree::BottomUpTree<SumData> stree(values);
+  return Measure([&] {
+           for (auto &query : queries) {
+             stree.Set(query.index, query.value);
+             checksum += stree.Fold(query.begin, query.end);
+           }
+         }) / queries.size() * 1e9;
+}
+
+int main() {
+  std::mt19937_64 rnd(239);
+  const size_t kQueries = 1 << 16;
+
+  std::cout << "nanoseconds per update and fold:\n"
+            << std::setw(10) << "size" << std::setw(14) << "vector" << std::setw(14) << "array"
+            << std::setw(14) << "bottom-up" << "\n";
+
+  for (int size = 1 << 10; size <= (1 << 22); size <<= 2) {
+    std::vector<int64_t> values(size);
+    for (auto &value : values) value = static_cast<int64_t>(rnd() % 1000);
+    std::vector<Query> queries(kQueries);
+    for (auto &query : queries) {
+      int l = rnd() % size, r = rnd() % size;
+      query = {static_cast<int>(rnd() % size), std::min(l, r), std::max(l, r) + 1,
+               static_cast<int64_t>(rnd() % 1000)};
+    }
+
+    int64_t checksum = 0;
+    std::cout << std::setw(10) << size << std::fixed << std::setprecision(2)
+              << std::setw(14) << PerQuery<segment_tree::VectorStorage>(values, queries, checksum)
+              << std::setw(14) << PerQuery<segment_tree::ArrayStorage>(values, queries, checksum)
+              << std::setw(14) << BottomUpPerQuery(values, queries, checksum)
+              << "\n";
+    if (checksum == 42) std::cout << "";
+  }
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace eytzinger {
+
+/**
+ * Static sorted set in Eytzinger (BFS) layout: node k has children 2k and
+ * 2k + 1, so first levels of the search stay in cache and next nodes of
+ * all the queries are prefetched long before they're visited.
+ *
+ * Descent is branchless: k = 2k + (node < value), and the answer is
+ * restored from k by dropping trailing ones along with one more bit.
+ */
+template <class T, class Less = std::less<T>>
+class Eytzinger {
+ public:
+  // [begin, end) should be sorted by less.
+  template <class It>
+  Eytzinger(It begin, It end, Less less = {})
+      : size_(std::distance(begin, end)),
+        nodes_(size_ + 1),
+        ranks_(size_ + 1, size_),
+        less_{less} {
+    std::vector<T> sorted(begin, end);
+    size_t rank = 0;
+    Build(sorted, 1, rank);
+  }
+
+  template <class Container>
+  explicit Eytzinger(const Container &container, Less less = {})
+      : Eytzinger(container.begin(), container.end(), less) {}
+
+  size_t size() const { return size_; }
+
+  // Returns position of first element not less than value in sorted order.
+  size_t LowerBound(const T &value) const {
+    size_t k = 1;
+    while (k <= size_) {
+      __builtin_prefetch(nodes_.data() + std::min(k * kPrefetchStride, size_));
+      k = 2 * k + less_(nodes_[k], value);
+    }
+    return Rank(k);
+  }
+
+  /**
+   * Answers queries in groups of kBatch interleaved level by level, so that
+   * memory latency of each lookup is hidden behind all the others.
+   */
+  std::vector<size_t> LowerBound(const std::vector<T> &values) const {
+    std::vector<size_t> result(values.size());
+    size_t k[kBatch];
+    for (size_t begin = 0; begin < values.size(); begin += kBatch) {
+      const size_t count = std::min(kBatch, values.size() - begin);
+      const T *batch = values.data() + begin;
+      std::fill(k, k + count, size_t{1});
+
+      for (size_t level = 0; level < levels_; ++level) {
+        for (size_t i = 0; i < count; ++i) {
+          // Finished queries look at unused nodes_[0] and stay where they are.
+          bool inside = k[i] <= size_;
+          size_t next = 2 * k[i] + less_(nodes_[inside ? k[i] : 0], batch[i]);
+          k[i] = inside ? next : k[i];
+          __builtin_prefetch(nodes_.data() + std::min(k[i], size_));
+        }
+      }
+      for (size_t i = 0; i < count; ++i) {
+        result[begin + i] = Rank(k[i]);
+      }
+    }
+    return result;
+  }
+
+ private:
+  // Queries interleaved by batched LowerBound.
+  static constexpr size_t kBatch = 16;
+  // Descendants of k three or four levels below share a cache line.
+  static constexpr size_t kPrefetchStride = std::max<size_t>(64 / sizeof(T), 1);
+
+  // Fills subtree of node k by in-order traversal of sorted values.
+  void Build(const std::vector<T> &sorted, size_t k, size_t &rank) {
+    if (k > size_) {
+      return;
+    }
+    Build(sorted, 2 * k, rank);
+    nodes_[k] = sorted[rank], ranks_[k] = rank++;
+    Build(sorted, 2 * k + 1, rank);
+    levels_ = std::max(levels_, Depth(k));
+  }
+
+  static size_t Depth(size_t k) { return 64 - __builtin_clzll(k); }
+
+  // Last left turn of the path ending at k is the answer, 0 means none.
+  size_t Rank(size_t k) const {
+    k >>= __builtin_ffsll(~k);
+    return ranks_[k];
+  }
+
+  size_t size_, levels_ = 0;
+  std::vector<T> nodes_;
+  std::vector<size_t> ranks_;
+  Less less_;
+};
+
+}  // namespace eytzinger
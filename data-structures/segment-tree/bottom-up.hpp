@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vector>
+
+namespace segment_tree {
+
+/**
+ * Non-recursive segment tree over the same Pure/Merge monoids as STree:
+ * leaves are nodes [size, 2 size), node i is a merge of 2i and 2i + 1, and
+ * both updates and folds climb from leaves to the root in plain loops.
+ * Build is O(n), Set and Fold are O(log n).
+ *
+ * Meant for commutative monoids such as sums, minimums and maximums, but
+ * Fold keeps operands in order, so other monoids work as well. There is
+ * no neutral element: fold starts from the boundary leaves.
+ */
+template <class Monoid, class Data = decltype(Monoid::Pure(int{}))>
+class BottomUpTree {
+ public:
+  template <class Unary>
+  BottomUpTree(int size, Unary unary) : size_(size), nodes_(2 * size) {
+    for (int i = 0; i < size; ++i) {
+      nodes_[size + i] = Monoid::Pure(unary(i));
+    }
+    for (int i = size - 1; i > 0; --i) {
+      nodes_[i] = Monoid::Merge(nodes_[2 * i], nodes_[2 * i + 1]);
+    }
+  }
+
+  template <class T>
+  explicit BottomUpTree(const std::vector<T> &xs)
+      : BottomUpTree(static_cast<int>(xs.size()), [&](int index) { return xs[index]; }) {}
+
+  int size() const { return size_; }
+
+  const Data &Get(int index) const { return nodes_[size_ + index]; }
+
+  template <class T>
+  void Set(int index, const T &value) {
+    int node = size_ + index;
+    nodes_[node] = Monoid::Pure(value);
+    for (node >>= 1; node > 0; node >>= 1) {
+      nodes_[node] = Monoid::Merge(nodes_[2 * node], nodes_[2 * node + 1]);
+    }
+  }
+
+  // Merge of elements [begin, end), range should be non-empty.
+  Data Fold(int begin, int end) const {
+    int l = size_ + begin, r = size_ + end - 1;
+    if (l == r) {
+      return nodes_[l];
+    }
+
+    Data left = nodes_[l++], right = nodes_[r];
+    for (; l < r; l >>= 1, r >>= 1) {
+      if (l & 1) left = Monoid::Merge(left, nodes_[l++]);
+      if (r & 1) right = Monoid::Merge(nodes_[--r], right);
+    }
+    return Monoid::Merge(left, right);
+  }
+
+ private:
+  int size_;
+  std::vector<Data> nodes_;
+};
+
+} // namespace segment_tree
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+
+namespace segment_tree {
+
+/**
+ * Lazy monoids extend Pure/Merge ones with tags, deferred maps of data:
+ *
+ *   using Tag = ...;
+ *   static Data Apply(const Tag &tag, const Data &data, int size);
+ *   static Tag Compose(const Tag &outer, const Tag &inner);
+ *
+ * Apply maps fold of `size` elements, Compose returns tag applying inner
+ * first and outer then. Both are static members resolved at compile time,
+ * nodes of such monoids are stored as LazyNode with pending tag of sons.
+ */
+template <class Monoid, class = void>
+struct is_lazy : std::false_type {};
+
+template <class Monoid>
+struct is_lazy<Monoid, std::void_t<typename Monoid::Tag>> : std::true_type {};
+
+template <class Data, class Tag>
+struct LazyNode {
+  Data data;
+  Tag tag;
+  bool pending = false;
+};
+
+// Data of stored node.
+template <class Stored>
+struct node_data {
+  using type = Stored;
+};
+
+template <class Data, class Tag>
+struct node_data<LazyNode<Data, Tag>> {
+  using type = Data;
+};
+
+template <class Monoid, class Data, bool = is_lazy<Monoid>::value>
+struct node_type {
+  using type = Data;
+};
+
+template <class Monoid, class Data>
+struct node_type<Monoid, Data, true> {
+  using type = LazyNode<Data, typename Monoid::Tag>;
+};
+
+// What storages keep per node: data itself, or data with a tag for lazy monoids.
+template <class Monoid, class Data>
+using node_type_t = typename node_type<Monoid, Data>::type;
+
+// x -> mul * x + add, assignment is Affine{0, value} and addition is Affine{1, value}.
+template <class T>
+struct Affine {
+  T mul, add;
+};
+
+template <class T>
+struct AffineSum {
+  using Tag = Affine<T>;
+
+  static T Pure(T value) { return value; }
+  static T Merge(T lhs, T rhs) { return lhs + rhs; }
+
+  static T Apply(const Tag &tag, T sum, int size) {
+    return tag.mul * sum + tag.add * static_cast<T>(size);
+  }
+
+  static Tag Compose(const Tag &outer, const Tag &inner) {
+    return {outer.mul * inner.mul, outer.mul * inner.add + outer.add};
+  }
+};
+
+template <class T>
+struct AddMin {
+  using Tag = T;
+
+  static T Pure(T value) { return value; }
+  static T Merge(T lhs, T rhs) { return std::min(lhs, rhs); }
+  static T Apply(T tag, T min, int /*size*/) { return min + tag; }
+  static T Compose(T outer, T inner) { return outer + inner; }
+};
+
+template <class T>
+struct AddMax {
+  using Tag = T;
+
+  static T Pure(T value) { return value; }
+  static T Merge(T lhs, T rhs) { return std::max(lhs, rhs); }
+  static T Apply(T tag, T max, int /*size*/) { return max + tag; }
+  static T Compose(T outer, T inner) { return outer + inner; }
+};
+
+} // namespace segment_tree
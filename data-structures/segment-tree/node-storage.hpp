@@ -22,11 +22,14 @@
 
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
+#include "lazy.hpp"
+
 namespace segment_tree {
 
-template <class MonoidType, class StoredType = decltype(MonoidType::Pure(int{}))>
+template <class MonoidType, class StoredType = node_type_t<MonoidType, decltype(MonoidType::Pure(int{}))>>
 class VectorStorage {
  public:
   using Data = StoredType;
@@ -40,6 +43,7 @@ class VectorStorage {
     using Monoid = MonoidType;
 
     Data &Get();
+    const Data &Get() const { return storage->storage[index].data; }
 
     NodeReference Left();
     NodeReference Right();
@@ -101,4 +105,56 @@ auto VectorStorage<Monoid, Stored>::NodeReference::Right() -> NodeReference {
   };
 }
 
+/**
+ * Dense storage of a tree over fixed size, nodes are laid out in preorder:
+ * node covering `size` elements at index i has left son at i + 1 and right
+ * one at i + 2 * (size / 2), just like Walker splits ranges at mid. That's
+ * exactly 2 * size - 1 nodes allocated once, and sons are found by
+ * arithmetic without branches, reallocations or pointer chasing.
+ *
+ * Left subtrees are next to their parents, so descents mostly go forward
+ * through memory. Unlike VectorStorage, all the nodes exist from the start,
+ * so it doesn't suit sparse trees over huge ranges.
+ */
+template <class MonoidType, class StoredType = node_type_t<MonoidType, decltype(MonoidType::Pure(int{}))>>
+class ArrayStorage {
+ public:
+  using Data = StoredType;
+  using Monoid = MonoidType;
+
+  explicit ArrayStorage(int size)
+      : storage(std::max(2 * size - 1, 1)),
+        size(size)
+  {}
+
+  class NodeReference {
+   public:
+    using Data = StoredType;
+    using Monoid = MonoidType;
+
+    Data &Get() { return *node; }
+    const Data &Get() const { return *node; }
+
+    NodeReference Left() { return {node + 1, size / 2}; }
+    NodeReference Right() { return {node + 2 * (size / 2), size - size / 2}; }
+
+   private:
+    friend class ArrayStorage;
+
+    NodeReference(Data *node, int size)
+        : node(node),
+          size(size)
+    {}
+
+    Data *node;
+    int size;
+  };
+
+  NodeReference Root() { return NodeReference{storage.data(), size}; }
+
+ private:
+  std::vector<Data> storage;
+  int size;
+};
+
 } // namespace segment_tree
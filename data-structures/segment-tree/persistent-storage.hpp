@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "lazy.hpp"
+
+namespace segment_tree {
+
+/**
+ * Persistent storage: every version is a root handle, versions share all
+ * the nodes they didn't change. Nodes are bump-allocated from one arena
+ * and addressed by index, node 0 is the shared empty one with Data{} and
+ * itself as both sons, so trees over huge ranges need no Build.
+ *
+ * Only the latest version is writable, Fork(version) starts a new latest
+ * version as a copy of given one. Writing walkers descending from Root()
+ * copy each node they pass into the latest version once, so an update
+ * copies only its O(log n) path, and reading sons in Walker::Update copies
+ * nothing. Root(version) gives ConstNodeReference to any version, walkers
+ * over it only read: Get() returns const data and Update doesn't compile.
+ * Rollback(version) drops all the later versions and releases their nodes
+ * at once, as they lie at the end of the arena.
+ */
+template <class MonoidType, class StoredType = decltype(MonoidType::Pure(int{}))>
+class PersistentStorage {
+  static_assert(!is_lazy<MonoidType>::value, "lazy tags would be pushed into shared nodes");
+
+ public:
+  using Data = StoredType;
+  using Monoid = MonoidType;
+
+  explicit PersistentStorage(int /*size*/) : nodes_(1, Node{Data{}, 0, 0, -1}) {
+    Fork(-1);
+  }
+
+  // Writable reference copies nodes it passes into the latest version.
+  template <bool kWritable>
+  class Reference {
+   public:
+    using Data = StoredType;
+    using Monoid = MonoidType;
+
+    template <bool kMutable = kWritable, class = std::enable_if_t<kMutable>>
+    Data &Get() { return storage->nodes_[Own()].data; }
+    const Data &Get() const { return storage->nodes_[index].data; }
+
+    Reference Left() { return Son(false); }
+    Reference Right() { return Son(true); }
+
+   private:
+    friend class PersistentStorage;
+
+    Reference(PersistentStorage *storage, int index, int parent, bool right)
+        : storage(storage),
+          index(index),
+          parent(parent),
+          right(right)
+    {}
+
+    // Copies node into the latest version unless it's there already.
+    int Own() {
+      if (kWritable && storage->nodes_[index].version != storage->latest()) {
+        int copy = storage->Allocate(storage->nodes_[index]);
+        auto &link = storage->nodes_[parent];
+        (right ? link.right : link.left) = copy;
+        index = copy;
+      }
+      return index;
+    }
+
+    Reference Son(bool right_son) {
+      int self = Own();
+      auto &node = storage->nodes_[self];
+      return {storage, right_son ? node.right : node.left, self, right_son};
+    }
+
+    PersistentStorage *storage;
+    int index, parent;
+    bool right;
+  };
+
+  using NodeReference = Reference<true>;
+  using ConstNodeReference = Reference<false>;
+
+  // Writable root of the latest version.
+  NodeReference Root() { return {this, roots_.back(), -1, false}; }
+
+  // Read-only root of given version.
+  ConstNodeReference Root(int version) { return {this, roots_[version], -1, false}; }
+
+  int latest() const { return static_cast<int>(roots_.size()) - 1; }
+  size_t nodes() const { return nodes_.size(); }
+
+  // Starts new latest version equal to given one or to empty tree for -1, returns its handle.
+  int Fork(int version) {
+    Node root = nodes_[version < 0 ? 0 : roots_[version]];
+    marks_.push_back(nodes_.size());
+    roots_.push_back(static_cast<int>(nodes_.size()));
+    Allocate(root);
+    return latest();
+  }
+
+  // Keeps versions up to given one, which becomes writable again.
+  void Rollback(int version) {
+    assert(0 <= version && version <= latest());
+    if (version < latest()) {
+      nodes_.resize(marks_[version + 1]);
+      roots_.resize(version + 1), marks_.resize(version + 1);
+    }
+  }
+
+ private:
+  struct Node {
+    Data data;
+    int left, right;
+    int version;
+  };
+
+  int Allocate(Node node) {
+    node.version = latest();
+    nodes_.push_back(node);
+    return static_cast<int>(nodes_.size()) - 1;
+  }
+
+  std::vector<Node> nodes_;
+  std::vector<int> roots_;
+  std::vector<size_t> marks_;
+};
+
+} // namespace segment_tree
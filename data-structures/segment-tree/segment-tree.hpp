@@ -22,7 +22,10 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include "node-storage.hpp"
+#include "persistent-storage.hpp"
 #include "walker.hpp"
 
 namespace segment_tree {
@@ -42,6 +45,12 @@ struct Builder {
   }
 };
 
+template <class Storage, class = void>
+struct is_persistent : std::false_type {};
+
+template <class Storage>
+struct is_persistent<Storage, std::void_t<typename Storage::ConstNodeReference>> : std::true_type {};
+
 template <class Storage>
 class STree {
  public:
@@ -63,20 +72,52 @@ class STree {
   template <class T = typename Storage::Monoid>
   auto Fold(int begin, int end, T &&monoid = {}) {
     return RangeQuery<T>{begin, end, std::forward<T>(monoid)}
+        .perform(QueryRoot());
+  }
+
+  // Read-only walker over given version, for persistent storages only.
+  auto Root(int version) {
+    return Walker<typename Storage::ConstNodeReference>{
+        storage_.Root(version),
+        begin_, end_,
+    };
+  }
+
+  const Storage &storage() const { return storage_; }
+
+  // Starts new latest version equal to given one, Root() writes to it.
+  int Fork(int version) { return storage_.Fork(version); }
+
+  // Drops all the versions after given one.
+  void Rollback(int version) { storage_.Rollback(version); }
+
+  // Applies tag of lazy monoid to all the elements of [begin, end).
+  template <class Tag>
+  void Apply(int begin, int end, const Tag &tag) {
+    RangeApply<Tag>{begin, end, tag}
         .perform(Root());
   }
 
  private:
+  // Persistent storages are queried by read-only root, so queries copy no nodes.
+  auto QueryRoot() {
+    if constexpr (is_persistent<Storage>::value) {
+      return Root(storage_.latest());
+    } else {
+      return Root();
+    }
+  }
+
   Storage storage_;
   int begin_, end_;
 };
 
-template <class Monoid>
+template <class Monoid, template <class, class> class StorageType = VectorStorage>
 struct stree_builder {
   template <class Unary>
   auto operator()(int size, Unary unary) {
     using NodeType = decltype(std::declval<Unary>()(0));
-    using Storage = VectorStorage<Monoid, NodeType>;
+    using Storage = StorageType<Monoid, node_type_t<Monoid, NodeType>>;
 
     auto stree = STree<Storage>(size);
     stree.Build(unary);
@@ -92,7 +133,7 @@ struct stree_builder {
   }
 };
 
-template <class Monoid>
-stree_builder<Monoid> build;
+template <class Monoid, template <class, class> class StorageType = VectorStorage>
+stree_builder<Monoid, StorageType> build;
 
 } // namespace segment_tree;
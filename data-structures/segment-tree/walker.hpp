@@ -22,26 +22,35 @@
 
 #pragma once
 
-#include <functional>
+#include "lazy.hpp"
 
 namespace segment_tree {
 
+// Calls func on scope exit, func is kept as is, without type erasure.
+template <class Func>
 struct Defer {
-  std::function<void()> func;
-
-  template <class Func>
-  Defer(Func func) : func(func) {}
+  Func func;
 
   ~Defer() noexcept {
     func();
   }
 };
 
+template <class Func>
+Defer(Func) -> Defer<Func>;
+
+/**
+ * Walker is a node along with its range [left, right). For lazy monoids
+ * Left() and Right() push pending tag of the node to both sons first, so
+ * any walker sees actual data of nodes it descends to.
+ */
 template <class NodeReference>
 class Walker {
  public:
-  using Data = typename NodeReference::Data;
   using Monoid = typename NodeReference::Monoid;
+  using Stored = typename NodeReference::Data;
+  using Data = typename node_data<Stored>::type;
+  static constexpr bool kLazy = is_lazy<Monoid>::value;
 
   NodeReference node;
   int left, right;
@@ -61,17 +70,68 @@ class Walker {
     return begin <= left && right <= end;
   }
 
-  Walker Left() { return {node.Left(), left, mid()}; }
-  Walker Right() { return {node.Right(), mid(), right}; }
+  Walker Left() {
+    Push();
+    return {node.Left(), left, mid()};
+  }
+
+  Walker Right() {
+    Push();
+    return {node.Right(), mid(), right};
+  }
+
+  // Const data for read-only references such as PersistentStorage::ConstNodeReference.
+  decltype(auto) Get() {
+    if constexpr (kLazy) {
+      return (node.Get().data);
+    } else {
+      return node.Get();
+    }
+  }
+
+  const Data &Get() const {
+    if constexpr (kLazy) {
+      return node.Get().data;
+    } else {
+      return node.Get();
+    }
+  }
 
-  Data &Get() { return node.Get(); }
+  // Sons are only read, so copy-on-write storages don't copy them.
   Data &Update() {
-    return node.Get() = Monoid::Merge(Left().Get(), Right().Get());
+    const Walker left_son = Left(), right_son = Right();
+    return Get() = Monoid::Merge(left_son.Get(), right_son.Get());
   }
 
   auto DeferredUpdate() {
     return Defer{[this] { Update(); }};
   }
+
+  // Maps data of the node and defers the same for its sons.
+  template <class Tag>
+  void Apply(const Tag &tag) {
+    static_assert(kLazy, "tags require lazy monoid");
+    auto &stored = node.Get();
+    stored.data = Monoid::Apply(tag, stored.data, size());
+    if (size() > 1) {
+      stored.tag = stored.pending ? Monoid::Compose(tag, stored.tag) : tag;
+      stored.pending = true;
+    }
+  }
+
+ private:
+  void Push() {
+    if constexpr (kLazy) {
+      auto &stored = node.Get();
+      if (stored.pending) {
+        // Sons may be created by VectorStorage, so stored is not used after that.
+        stored.pending = false;
+        auto tag = stored.tag;
+        Walker{node.Left(), left, mid()}.Apply(tag);
+        Walker{node.Right(), mid(), right}.Apply(tag);
+      }
+    }
+  }
 };
 
 template <class Monoid>
@@ -88,8 +148,6 @@ struct RangeQuery {
     auto left = walker.Left();
     auto right = walker.Right();
 
-    walker.DeferredUpdate();
-
     if (left.disjoint(begin, end)) {
       return perform(right);
     }
@@ -100,4 +158,28 @@ struct RangeQuery {
   }
 };
 
+template <class Tag>
+struct RangeApply {
+  int begin, end;
+  Tag tag;
+
+  template <class Walker>
+  void perform(Walker walker) {
+    if (walker.inside(begin, end)) {
+      walker.Apply(tag);
+      return;
+    }
+
+    auto left = walker.Left();
+    auto right = walker.Right();
+    if (!left.disjoint(begin, end)) {
+      perform(left);
+    }
+    if (!right.disjoint(begin, end)) {
+      perform(right);
+    }
+    walker.Update();
+  }
+};
+
 } // namespace segment_tree
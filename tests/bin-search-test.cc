@@ -0,0 +1,70 @@
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "../algebra/bin_search.hpp"
+
+namespace {
+
+// Stand-in for Float: wraps double with explicit conversions both ways.
+struct Tolerant {
+  double value;
+  explicit Tolerant(double value = 0) : value{value} {}
+  explicit operator double() const { return value; }
+};
+
+}  // namespace
+
+TEST_CASE("Integer bisection") {
+  REQUIRE(BinSearch(0, 100, [](int x) { return x * x <= 50; }) == 7);
+  REQUIRE(BinSearch(100, 0, [](int x) { return x * x >= 50; }) == 8);
+
+  REQUIRE(BitBinSearch(int64_t{-1'000'000'000'000}, int64_t{1'000'000'000'000},
+                       [](int64_t x) { return x <= -12345; }) == -12345);
+  REQUIRE(BitBinSearch(uint32_t{0}, ~uint32_t{0}, [](uint32_t x) { return x < 3'000'000'000u; })
+          == 2'999'999'999u);
+}
+
+TEST_CASE("Floating point bisection takes at most 64 calls") {
+  int calls = 0;
+  auto root = BinSearch(0.0, 1e300, [&](double x) { ++calls; return x * x <= 2; });
+  REQUIRE(calls <= 64);
+  REQUIRE(root * root <= 2);
+  REQUIRE(std::nextafter(root, 1e300) * std::nextafter(root, 1e300) > 2);
+
+  calls = 0;
+  auto tiny = BinSearch(-1.0, 1.0, [&](double x) { ++calls; return x < 1e-300; });
+  REQUIRE(calls <= 64);
+  REQUIRE(tiny < 1e-300);
+  REQUIRE(std::nextafter(tiny, 1.0) >= 1e-300);
+
+  calls = 0;
+  auto negative = BinSearch(-1e10f, 0.0f, [&](float x) { ++calls; return x <= -3.5f; });
+  REQUIRE(calls <= 32);
+  REQUIRE(negative == -3.5f);
+
+  calls = 0;
+  auto custom = BitBinSearch(Tolerant(0), Tolerant(10), [&](Tolerant x) {
+    ++calls;
+    return std::exp(static_cast<double>(x)) <= 100;
+  });
+  REQUIRE(calls <= 64);
+  REQUIRE(std::abs(static_cast<double>(custom) - std::log(100)) < 1e-12);
+}
+
+TEST_CASE("Parallel k-ary bisection") {
+  for (size_t threads : {1, 2, 3, 8}) {
+    std::atomic<int> calls = 0;
+    auto root = ParallelBinSearch(0.0, 1e300, [&](double x) { ++calls; return x * x <= 2; }, threads);
+    REQUIRE(root == BinSearch(0.0, 1e300, [](double x) { return x * x <= 2; }));
+    REQUIRE(calls <= static_cast<int>(64 * threads));
+
+    REQUIRE(ParallelBinSearch(0, 1000, [](int x) { return x <= 777; }, threads) == 777);
+    REQUIRE(ParallelBinSearch(1000, 0, [](int x) { return x >= 5; }, threads) == 5);
+    REQUIRE(ParallelBinSearch(7, 7, [](int) { return true; }, threads) == 7);
+    REQUIRE(ParallelBinSearch(7, 8, [](int) { return true; }, threads) == 7);
+  }
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch_all.hpp>
+
+#include <thread>
+
+#include "../algebra/c.hpp"
+
+namespace {
+
+template <class T>
+T NaiveBinomial(int64_t n, int64_t k) {
+  std::vector<std::vector<T>> pascal(n + 1, std::vector<T>(n + 1, T(0)));
+  for (int64_t i = 0; i <= n; ++i) {
+    pascal[i][0] = T(1);
+    for (int64_t j = 1; j <= i; ++j) {
+      pascal[i][j] = pascal[i - 1][j - 1] + pascal[i - 1][j];
+    }
+  }
+  return k < 0 || k > n ? T(0) : pascal[n][k];
+}
+
+}  // namespace
+
+TEST_CASE("Binomials grow on demand") {
+  using Mint = Z<998'244'353>;
+  C<Mint> c;
+
+  REQUIRE(c(0, 0) == Mint(1));
+  REQUIRE(c(5, 2) == Mint(10));
+  REQUIRE(c(5, 6) == Mint(0));
+  REQUIRE(c(5, -1) == Mint(0));
+  REQUIRE(c.size() >= 6);
+
+  for (int64_t k = 0; k <= 60; ++k) {
+    REQUIRE(c(60, k) == NaiveBinomial<Mint>(60, k));
+  }
+  REQUIRE(c(100'000, 50'000) / c(99'999, 49'999) == Mint(2));
+}
+
+TEST_CASE("Binomials by small prime use Lucas' theorem") {
+  using Mint = Z<7>;
+  C<Mint> c;
+
+  for (int64_t n = 0; n <= 100; ++n) {
+    for (int64_t k = 0; k <= n; ++k) {
+      REQUIRE(c(n, k) == NaiveBinomial<Mint>(n, k));
+    }
+  }
+  REQUIRE(c.size() == 7);
+  int64_t power = 1;
+  for (int i = 0; i < 20; ++i) power *= 7;
+  REQUIRE(c(5 * power + 3, 2 * power + 1) == Mint(30));
+  REQUIRE(c(5 * power + 3, 2 * power + 4) == Mint(0));
+}
+
+TEST_CASE("Batch binomials are shared across threads") {
+  using Mint = Z<1'000'000'007>;
+  C<Mint> c;
+
+  std::vector<std::pair<int64_t, int64_t>> queries;
+  for (int64_t n = 0; n < 2000; n += 7) {
+    queries.emplace_back(n, n / 3);
+  }
+  auto batch = c.Batch(queries);
+  REQUIRE(c.size() >= 1994);
+
+  const C<Mint> &shared = c;
+  std::vector<Mint> parallel(queries.size());
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t] {
+      for (size_t i = t; i < queries.size(); i += 4) {
+        parallel[i] = shared(queries[i].first, queries[i].second);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  REQUIRE(parallel == batch);
+  REQUIRE(batch[3] == NaiveBinomial<Mint>(21, 7));
+}
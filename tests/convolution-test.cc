@@ -0,0 +1,100 @@
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "../algebra/convolution.hpp"
+#include "../algebra/modular.hpp"
+#include "../algebra/montgomery.hpp"
+
+namespace {
+
+std::atomic<size_t> allocations = 0;
+
+template <class T>
+std::vector<T> RandomValues(size_t size, std::mt19937 &rnd) {
+  std::vector<T> result(size);
+  for (auto &value : result) value = T(static_cast<int64_t>(rnd() % 1'000'000));
+  return result;
+}
+
+}  // namespace
+
+// All the global allocations are counted. Every replaced operator new takes
+// memory from malloc and every replaced operator delete returns it by free,
+// sized, array and nothrow forms included, so that they always match each other.
+void *operator new(size_t size) {
+  ++allocations;
+  if (void *pointer = std::malloc(size ? size : 1)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  ++allocations;
+  return std::malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept { return operator new(size, tag); }
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { std::free(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { std::free(pointer); }
+
+TEMPLATE_TEST_CASE("Workspace multiplication agrees with schoolbook", "",
+                   Z<998'244'353>, MontgomeryZ<998'244'353>, Z<1'000'000'007>, int64_t) {
+  std::mt19937 rnd(239);
+  convolution::ConvolutionWorkspace<TestType> workspace;
+  for (auto [n, m] : std::vector<std::pair<size_t, size_t>>{
+           {0, 5}, {1, 1}, {40, 7}, {100, 100}, {1000, 40}, {300, 1000}, {2000, 2000}}) {
+    auto lhs = RandomValues<TestType>(n, rnd), rhs = RandomValues<TestType>(m, rnd);
+    std::vector<TestType> out(n && m ? n + m - 1 : 0, TestType(7));
+    workspace.MultiplyInto(out, lhs, rhs);
+    REQUIRE(out == convolution::schoolbook(lhs, rhs));
+
+    std::vector<TestType> other(out.size());
+    convolution::multiply_into(other, lhs, rhs);
+    REQUIRE(other == out);
+  }
+}
+
+TEST_CASE("Workspace allocates nothing after warm-up") {
+  using Mint = Z<998'244'353>;
+  std::mt19937 rnd(7);
+
+  convolution::ConvolutionWorkspace<Mint> workspace;
+  std::vector<std::vector<Mint>> operands;
+  // Largest products take transforms of 2^18 values, which would run on
+  // several threads by default.
+  for (size_t size : {10, 50, 100, 3000, 5000, 100'000}) {
+    operands.push_back(RandomValues<Mint>(size, rnd));
+  }
+  std::vector<Mint> out(200'000);
+
+  auto run = [&] {
+    for (const auto &lhs : operands) {
+      for (const auto &rhs : operands) {
+        ModularSpan<Mint> span(out.data(), lhs.size() + rhs.size() - 1);
+        workspace.MultiplyInto(span, lhs, rhs);
+      }
+    }
+  };
+  size_t start = allocations;
+  run();
+  REQUIRE(allocations > start);
+
+  size_t before = allocations;
+  run();
+  size_t after = allocations;
+  REQUIRE(after == before);
+}
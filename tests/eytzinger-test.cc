@@ -0,0 +1,52 @@
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <data-structures/eytzinger.hpp>
+
+TEST_CASE("Eytzinger sample test") {
+  std::vector<int64_t> values{1, 3, 3, 5, 8, 13};
+  eytzinger::Eytzinger<int64_t> index(values);
+
+  REQUIRE(index.size() == 6);
+  REQUIRE(index.LowerBound(0) == 0);
+  REQUIRE(index.LowerBound(1) == 0);
+  REQUIRE(index.LowerBound(3) == 1);
+  REQUIRE(index.LowerBound(4) == 3);
+  REQUIRE(index.LowerBound(13) == 5);
+  REQUIRE(index.LowerBound(14) == 6);
+
+  eytzinger::Eytzinger<int64_t> empty(std::vector<int64_t>{});
+  REQUIRE(empty.LowerBound(5) == 0);
+  REQUIRE(empty.LowerBound(std::vector<int64_t>{1, 2}) == std::vector<size_t>{0, 0});
+
+  std::vector<int> descending{9, 7, 7, 2};
+  eytzinger::Eytzinger<int, std::greater<int>> reversed(descending);
+  REQUIRE(reversed.LowerBound(7) == 1);
+  REQUIRE(reversed.LowerBound(1) == 4);
+}
+
+TEST_CASE("Eytzinger random test") {
+  std::mt19937_64 rnd(239);
+  for (size_t size : {1, 2, 3, 7, 8, 15, 16, 17, 100, 1000, 65536, 100000}) {
+    std::vector<int64_t> values(size);
+    for (auto &value : values) value = static_cast<int64_t>(rnd() % (2 * size));
+    std::sort(values.begin(), values.end());
+    eytzinger::Eytzinger<int64_t> index(values.begin(), values.end());
+
+    std::vector<int64_t> queries(1000);
+    for (auto &query : queries) query = static_cast<int64_t>(rnd() % (2 * size + 2)) - 1;
+    auto batch = index.LowerBound(queries);
+
+    for (size_t i = 0; i < queries.size(); ++i) {
+      auto expected = static_cast<size_t>(
+          std::lower_bound(values.begin(), values.end(), queries[i]) - values.begin());
+      REQUIRE(index.LowerBound(queries[i]) == expected);
+      REQUIRE(batch[i] == expected);
+    }
+  }
+}
@@ -0,0 +1,94 @@
+#include <catch2/catch_all.hpp>
+
+#include <array>
+#include <random>
+
+#include "../algebra/bin_pow.hpp"
+#include "../algebra/linear_recurrence.hpp"
+#include "../algebra/modular.hpp"
+
+namespace {
+
+using Mint = Z<998'244'353>;
+
+struct Matrix2 {
+  std::array<Mint, 4> values;
+
+  Matrix2 operator*(const Matrix2 &rhs) const {
+    const auto &[a, b, c, d] = values;
+    const auto &[e, f, g, h] = rhs.values;
+    return {{a * e + b * g, a * f + b * h, c * e + d * g, c * f + d * h}};
+  }
+};
+
+}  // namespace
+
+TEST_CASE("BinPow") {
+  static_assert(BinPow(3, 0) == 1);
+  static_assert(BinPow(3, 4) == 81);
+  static_assert(BinPow(int64_t{2}, 62) == int64_t{1} << 62);
+
+  REQUIRE(BinPow(Mint(2), 0) == Mint(1));
+  REQUIRE(BinPow(Mint(2), 23) == Mint(1 << 23));
+
+  // Matrix2 has no neutral element, but positive powers work anyway.
+  auto fibonacci = BinPow(Matrix2{{Mint(1), Mint(1), Mint(1), Mint(0)}}, 10);
+  REQUIRE(fibonacci.values[1] == Mint(55));
+}
+
+TEST_CASE("Berlekamp-Massey finds shortest recurrence") {
+  REQUIRE(BerlekampMassey(std::vector<Mint>{}).empty());
+  REQUIRE(BerlekampMassey(std::vector<Mint>(10, Mint(0))).empty());
+  REQUIRE(BerlekampMassey(std::vector<Mint>{1, 2, 4, 8, 16}) == std::vector<Mint>{2});
+
+  std::vector<Mint> fibonacci{0, 1};
+  for (size_t i = 2; i < 20; ++i) {
+    fibonacci.push_back(fibonacci[i - 1] + fibonacci[i - 2]);
+  }
+  REQUIRE(BerlekampMassey(fibonacci) == std::vector<Mint>{1, 1});
+
+  std::mt19937 rnd(13);
+  for (size_t order : {1, 5, 40, 150}) {
+    std::vector<Mint> coefficients(order), sequence(order);
+    for (auto &value : coefficients) value = Mint(rnd() % 998'244'353);
+    for (auto &value : sequence) value = Mint(rnd() % 998'244'353);
+    for (size_t i = order; i < 2 * order + 10; ++i) {
+      Mint next = 0;
+      for (size_t j = 0; j < order; ++j) next += coefficients[j] * sequence[i - 1 - j];
+      sequence.push_back(next);
+    }
+    REQUIRE(BerlekampMassey(sequence) == coefficients);
+  }
+}
+
+TEST_CASE("N-th term of linear recurrence") {
+  LinearRecurrence<Mint> fibonacci({Mint(0), Mint(1)}, {Mint(1), Mint(1)});
+  REQUIRE(fibonacci.Nth(0) == Mint(0));
+  REQUIRE(fibonacci.Nth(10) == Mint(55));
+
+  const int64_t huge = 1'000'000'000'000'000'000;
+  auto matrix = BinPow(Matrix2{{Mint(1), Mint(1), Mint(1), Mint(0)}}, huge);
+  REQUIRE(fibonacci.Nth(huge) == matrix.values[1]);
+
+  std::mt19937 rnd(7);
+  for (size_t order : {1, 3, 100, 300}) {
+    std::vector<Mint> sequence(order);
+    std::vector<Mint> coefficients(order);
+    for (auto &value : coefficients) value = Mint(rnd() % 998'244'353);
+    for (auto &value : sequence) value = Mint(rnd() % 998'244'353);
+    for (size_t i = order; i < 1000; ++i) {
+      Mint next = 0;
+      for (size_t j = 0; j < order; ++j) next += coefficients[j] * sequence[i - 1 - j];
+      sequence.push_back(next);
+    }
+
+    auto recurrence = LinearRecurrence<Mint>::Find(
+        std::vector<Mint>(sequence.begin(), sequence.begin() + 2 * order));
+    REQUIRE(recurrence.order() == order);
+    for (int64_t n : {0, 1, 2, 500, 999}) {
+      if (static_cast<size_t>(n) < sequence.size()) {
+        REQUIRE(recurrence.Nth(n) == sequence[n]);
+      }
+    }
+  }
+}
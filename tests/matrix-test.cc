@@ -0,0 +1,94 @@
+#include <catch2/catch_all.hpp>
+
+#include <random>
+#include <type_traits>
+
+#include "../algebra/matrix.hpp"
+#include "../algebra/montgomery.hpp"
+
+namespace {
+
+template <class T>
+Matrix<T> RandomMatrix(size_t rows, size_t cols, std::mt19937 &rnd) {
+  Matrix<T> result(rows, cols);
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < cols; ++j) {
+      result[i][j] = T(static_cast<int64_t>(rnd() % 998'244'353));
+    }
+  }
+  return result;
+}
+
+template <class T>
+Matrix<T> NaiveMultiply(const Matrix<T> &lhs, const Matrix<T> &rhs) {
+  Matrix<T> result(lhs.rows(), rhs.cols());
+  for (size_t i = 0; i < lhs.rows(); ++i) {
+    for (size_t k = 0; k < lhs.cols(); ++k) {
+      for (size_t j = 0; j < rhs.cols(); ++j) {
+        result[i][j] += lhs[i][k] * rhs[k][j];
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("Matrix multiplication", "", Z<998'244'353>, MontgomeryZ<998'244'353>) {
+  std::mt19937 rnd(42);
+  for (auto [n, m, k] : std::vector<std::tuple<size_t, size_t, size_t>>{
+           {1, 1, 1}, {3, 5, 2}, {64, 64, 64}, {70, 130, 65}, {129, 1, 200}}) {
+    auto lhs = RandomMatrix<TestType>(n, m, rnd), rhs = RandomMatrix<TestType>(m, k, rnd);
+    REQUIRE(lhs * rhs == NaiveMultiply(lhs, rhs));
+  }
+
+  auto matrix = RandomMatrix<TestType>(10, 20, rnd);
+  REQUIRE(matrix.Transposed().Transposed() == matrix);
+  REQUIRE((matrix + matrix) - matrix == matrix);
+}
+
+TEST_CASE("Gaussian elimination") {
+  using Mint = Z<998'244'353>;
+
+  Matrix<Mint> matrix{{2, 0, 1}, {1, 3, 2}, {1, 1, 2}};
+  REQUIRE(matrix.Rank() == 3);
+  REQUIRE(matrix.Determinant() == Mint(6));
+  REQUIRE(matrix * matrix.Inverse() == Matrix<Mint>::Identity(3));
+
+  Matrix<Mint> singular{{1, 2, 3}, {2, 4, 6}, {0, 1, 1}};
+  REQUIRE(singular.Rank() == 2);
+  REQUIRE(singular.Determinant() == Mint(0));
+
+  Matrix<Mint> swapped{{0, 1}, {1, 0}};
+  REQUIRE(swapped.Determinant() == Mint(-1));
+  REQUIRE(Matrix<Mint>(3, 5).Rank() == 0);
+  // Integers are never converted to matrices of size n x 0, so m * 2 doesn't compile.
+  static_assert(!std::is_convertible_v<int, Matrix<Mint>>);
+  REQUIRE(Matrix<Mint>{{1, 2, 3, 4}, {2, 4, 6, 9}}.Rank() == 2);
+
+  std::mt19937 rnd(1);
+  auto lhs = RandomMatrix<Mint>(100, 100, rnd), rhs = RandomMatrix<Mint>(100, 100, rnd);
+  REQUIRE((lhs * rhs).Determinant() == lhs.Determinant() * rhs.Determinant());
+  REQUIRE(lhs.Inverse() * lhs == Matrix<Mint>::Identity(100));
+}
+
+TEST_CASE("Matrix power") {
+  using Mint = Z<1'000'000'007>;
+
+  Matrix<Mint> fibonacci{{1, 1}, {1, 0}};
+  REQUIRE(BinPow(fibonacci, 0) == Matrix<Mint>::Identity(2));
+  // Generic BinPow must not take Matrix(1) of size 1 x 0 for neutral element.
+  REQUIRE(BinPow<Matrix<Mint>>(fibonacci, 0) == Matrix<Mint>::Identity(2));
+  REQUIRE(BinPow<Matrix<Mint>>(fibonacci, 10)[0][1] == Mint(55));
+  REQUIRE(BinPow(fibonacci, 10)[0][1] == Mint(55));
+  // F(10^18) mod 1e9+7
+  REQUIRE(BinPow(fibonacci, 1'000'000'000'000'000'000)[0][1] == Mint(209'783'453));
+
+  std::mt19937 rnd(3);
+  auto matrix = RandomMatrix<Mint>(30, 30, rnd);
+  auto expected = Matrix<Mint>::Identity(30);
+  for (int i = 0; i < 13; ++i) {
+    expected = expected * matrix;
+  }
+  REQUIRE(BinPow(matrix, 13) == expected);
+}
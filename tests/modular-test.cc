@@ -1,6 +1,10 @@
 #include <catch2/catch_all.hpp>
 
+#include <random>
+
 #include "../algebra/modular.hpp"
+#include "../algebra/montgomery.hpp"
+#include "../algebra/barrett.hpp"
 
 namespace pure_env {
 
@@ -30,6 +34,27 @@ TEST_CASE("Simple modular test") {
   REQUIRE(1_z / 2_z == 7_z);
   REQUIRE(6_z / 3_z == 2_z);
   REQUIRE(6_z / 5_z == 9_z);
+  REQUIRE(1_z / (0_z - 2_z) == 6_z);
+
+  REQUIRE(FermatInverse(2_z) == 7_z);
+  REQUIRE(FermatInverse(12_z) == 12_z);
+}
+
+TEST_CASE("Extended gcd") {
+  static_assert(lrp_gcd(240, 46) == std::pair<int64_t, int64_t>{-9, 47});
+  static_assert(inverse_mod(3, 7) == 5);
+  static_assert(inverse_mod(-3, 7) == 2);
+  static_assert(inverse_mod(1, 1'000'000'007) == 1);
+
+  std::mt19937_64 rnd(17);
+  const int64_t mod = (int64_t{1} << 61) - 1;
+  for (int i = 0; i < 1000; ++i) {
+    int64_t number = static_cast<int64_t>(rnd() % (mod - 1)) + 1;
+    auto inverse = inverse_mod(number, mod);
+    REQUIRE(inverse >= 0);
+    REQUIRE(inverse < mod);
+    REQUIRE(static_cast<__int128>(number) * inverse % mod == 1);
+  }
 }
 
 namespace dynamic_env {
@@ -62,3 +87,153 @@ TEST_CASE("Dynamic modulo test") {
   REQUIRE(6_z / 3_z == 2_z);
   REQUIRE(6_z / 5_z == 9_z);
 }
+
+namespace montgomery_env {
+
+using Mint = MontgomeryZ<13>;
+
+Mint operator""_z(unsigned long long value) {
+  return Mint{static_cast<int64_t>(value)};
+}
+
+}  // namespace montgomery_env
+
+TEST_CASE("Montgomery modulo test") {
+  using namespace montgomery_env;
+
+  REQUIRE(2_z + 13_z == 15_z);
+  REQUIRE(-1_z + 2_z == 1_z);
+  REQUIRE(10_z + 20_z == 4_z);
+
+  REQUIRE(2_z - 4_z == 11_z);
+  REQUIRE(2_z - 2_z == 0_z);
+  REQUIRE(2_z + 10_z == -1_z);
+
+  REQUIRE(2 * 2_z == 4_z);
+  REQUIRE(-2 * 2_z == 9_z);
+  REQUIRE(3 * 5_z == 2_z);
+
+  REQUIRE(1_z / 2_z == 7_z);
+  REQUIRE(6_z / 3_z == 2_z);
+  REQUIRE(6_z / 5_z == 9_z);
+}
+
+TEST_CASE("Montgomery 64-bit modulo test") {
+  constexpr int64_t mod = (int64_t{1} << 62) + 135;
+  using Mint = MontgomeryZ<mod>;
+
+  std::mt19937_64 rnd(239);
+  for (int i = 0; i < 1000; ++i) {
+    int64_t lhs = static_cast<int64_t>(rnd() % mod), rhs = static_cast<int64_t>(rnd() % mod);
+    auto expected = static_cast<int64_t>(static_cast<__int128>(lhs) * rhs % mod);
+
+    REQUIRE(static_cast<int64_t>(Mint(lhs) * Mint(rhs)) == expected);
+    REQUIRE(static_cast<int64_t>(Mint(lhs) + Mint(rhs)) == static_cast<int64_t>((static_cast<__int128>(lhs) + rhs) % mod));
+    REQUIRE(Mint(lhs) * Mint(rhs) / Mint(rhs) == Mint(lhs));
+  }
+}
+
+namespace barrett_env {
+
+using Mint = BarrettModular<>;
+
+Mint operator""_z(unsigned long long value) {
+  return Mint{static_cast<int64_t>(value)};
+}
+
+}  // namespace barrett_env
+
+TEST_CASE("Barrett modulo test") {
+  using namespace barrett_env;
+  BarrettModulo<> modulo(13);
+
+  REQUIRE(2_z + 13_z == 15_z);
+  REQUIRE(-1_z + 2_z == 1_z);
+  REQUIRE(10_z + 20_z == 4_z);
+
+  REQUIRE(2_z - 4_z == 11_z);
+  REQUIRE(2_z - 2_z == 0_z);
+  REQUIRE(2_z + 10_z == -1_z);
+
+  REQUIRE(2 * 2_z == 4_z);
+  REQUIRE(-2 * 2_z == 9_z);
+  REQUIRE(3 * 5_z == 2_z);
+
+  REQUIRE(1_z / 2_z == 7_z);
+  REQUIRE(6_z / 3_z == 2_z);
+  REQUIRE(6_z / 5_z == 9_z);
+
+  {
+    BarrettModulo<> nested(7);
+    REQUIRE(3 * 5_z == 1_z);
+  }
+  REQUIRE(3 * 5_z == 2_z);
+}
+
+TEST_CASE("Barrett random modulo test") {
+  using Mint = BarrettModular<>;
+
+  std::mt19937_64 rnd(239);
+  for (int64_t mod : {int64_t{1'000'000'007}, int64_t{4'294'967'291}, (int64_t{1} << 62) - 57}) {
+    BarrettModulo<> modulo(mod);
+    for (int i = 0; i < 1000; ++i) {
+      auto lhs = static_cast<int64_t>(rnd() >> 1), rhs = static_cast<int64_t>(rnd() >> 1);
+      auto expected = static_cast<int64_t>(static_cast<__int128>(lhs % mod) * (rhs % mod) % mod);
+
+      REQUIRE(static_cast<int64_t>(Mint(lhs)) == lhs % mod);
+      REQUIRE(static_cast<int64_t>(Mint(-lhs)) == (mod - lhs % mod) % mod);
+      REQUIRE(static_cast<int64_t>(Mint(lhs) * Mint(rhs)) == expected);
+    }
+  }
+}
+
+template <class Mint>
+void TestBatchOperations(int64_t mod) {
+  std::mt19937_64 rnd(239);
+  for (size_t size : {0, 1, 7, 8, 9, 100, 1000}) {
+    std::vector<Mint> lhs(size), rhs(size), out(size, Mint(5));
+    // Differences are negative as often as not for Modular.
+    auto random = [&] {
+      return Mint(static_cast<int64_t>(rnd() % mod)) - Mint(static_cast<int64_t>(rnd() % mod));
+    };
+    for (auto &x : lhs) x = random();
+    for (auto &x : rhs) x = random();
+    // Some of values aren't normalized since construction.
+    for (size_t i = 0; i < size; i += 7) lhs[i] = Mint(mod + static_cast<int64_t>(rnd() % (mod / 2 + 1)));
+
+    batch::Add(out, lhs, rhs);
+    for (size_t i = 0; i < size; ++i) REQUIRE(out[i] == lhs[i] + rhs[i]);
+
+    batch::Subtract(out, lhs, rhs);
+    for (size_t i = 0; i < size; ++i) REQUIRE(out[i] == lhs[i] - rhs[i]);
+
+    batch::Multiply(out, lhs, rhs);
+    for (size_t i = 0; i < size; ++i) REQUIRE(out[i] == lhs[i] * rhs[i]);
+
+    auto expected = out;
+    batch::MultiplyAdd(out, lhs, rhs);
+    for (size_t i = 0; i < size; ++i) REQUIRE(out[i] == expected[i] + lhs[i] * rhs[i]);
+
+    Mint dot = 0;
+    for (size_t i = 0; i < size; ++i) dot += lhs[i] * rhs[i];
+    REQUIRE(batch::Dot(lhs, rhs) == dot);
+
+    for (auto &x : rhs) if (x == Mint(0)) x = Mint(1);
+    batch::Inverse(out, rhs);
+    for (size_t i = 0; i < size; ++i) REQUIRE(out[i] * rhs[i] == Mint(1));
+    batch::Inverse(rhs, rhs);
+    REQUIRE(rhs == out);
+  }
+}
+
+TEST_CASE("Batch modular operations") {
+  TestBatchOperations<Z<998'244'353>>(998'244'353);
+  TestBatchOperations<Z<2'147'483'647>>(2'147'483'647);
+  TestBatchOperations<Z<3>>(3);
+  TestBatchOperations<MontgomeryZ<998'244'353>>(998'244'353);
+  TestBatchOperations<MontgomeryZ<2'147'483'647>>(2'147'483'647);
+  TestBatchOperations<MontgomeryZ<(int64_t{1} << 62) + 135>>((int64_t{1} << 62) + 135);
+
+  BarrettModulo<> modulo(1'000'000'007);
+  TestBatchOperations<BarrettModular<>>(1'000'000'007);
+}
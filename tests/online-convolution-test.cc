@@ -0,0 +1,47 @@
+#include <catch2/catch_all.hpp>
+
+#include <random>
+#include <vector>
+
+#include "../algebra/convolution.hpp"
+#include "../algebra/modular.hpp"
+#include "../algebra/montgomery.hpp"
+#include "../algebra/online_convolution.hpp"
+
+TEMPLATE_TEST_CASE("Online convolution agrees with schoolbook", "",
+                   Z<998'244'353>, MontgomeryZ<998'244'353>, Z<1'000'000'007>, int64_t) {
+  std::mt19937 rnd(239);
+  for (size_t size : {1, 2, 3, 64, 65, 513, 2000}) {
+    std::vector<TestType> f(size), g(size);
+    for (size_t i = 0; i < size; ++i) {
+      f[i] = TestType(static_cast<int64_t>(rnd() % 1'000'000));
+      g[i] = TestType(static_cast<int64_t>(rnd() % 1'000'000));
+    }
+    auto expected = convolution::schoolbook(f, g);
+
+    convolution::OnlineConvolution<TestType> online;
+    for (size_t i = 0; i < size; ++i) {
+      REQUIRE(online.Push(f[i], g[i]) == expected[i]);
+    }
+    REQUIRE(online.size() == size);
+  }
+}
+
+TEST_CASE("Online convolution feeds self-referential recurrence") {
+  using Mint = Z<998'244'353>;
+  // Catalan numbers: c[n + 1] = sum c[k] c[n - k].
+  const size_t size = 3000;
+  std::vector<Mint> catalan(size + 1, Mint(0));
+  catalan[0] = Mint(1);
+  for (size_t n = 0; n < size; ++n) {
+    for (size_t k = 0; k <= n; ++k) catalan[n + 1] += catalan[k] * catalan[n - k];
+  }
+
+  convolution::OnlineConvolution<Mint> online;
+  Mint next(1);
+  for (size_t n = 0; n < size; ++n) {
+    REQUIRE(next == catalan[n]);
+    next = online.Push(next, next);
+  }
+  REQUIRE(next == catalan[size]);
+}
@@ -0,0 +1,402 @@
+#include <catch2/catch_all.hpp>
+
+#include <random>
+
+#include <algebra/polynomial.hpp>
+#include <algebra/subproduct_tree.hpp>
+
+namespace {
+
+template <class T>
+Polynomial<T> NaiveMultiply(const Polynomial<T> &lhs, const Polynomial<T> &rhs) {
+  Polynomial<T> result(lhs.degree() + rhs.degree() - 1);
+  for (size_t i = 0; i < lhs.degree(); ++i) {
+    for (size_t j = 0; j < rhs.degree(); ++j) {
+      result[i + j] += lhs[i] * rhs[j];
+    }
+  }
+  return result;
+}
+
+template <class T, class Gen>
+Polynomial<T> RandomPolynomial(size_t degree, Gen &&gen) {
+  Polynomial<T> result(degree);
+  for (size_t i = 0; i < degree; ++i) {
+    result[i] = T(gen());
+  }
+  return result;
+}
+
+template <class T>
+void RequireEqual(const Polynomial<T> &lhs, const Polynomial<T> &rhs) {
+  REQUIRE(lhs.degree() == rhs.degree());
+  for (size_t i = 0; i < lhs.degree(); ++i) {
+    REQUIRE(lhs[i] == rhs[i]);
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Integer polynomial multiplication") {
+  auto lhs = Polynomial<int64_t>{1, 2, 3};
+  auto rhs = Polynomial<int64_t>{4, 5};
+  RequireEqual(lhs * rhs, Polynomial<int64_t>{4, 13, 22, 15});
+
+  std::mt19937 rnd(239);
+  auto gen = [&] { return static_cast<int64_t>(rnd() % 1000); };
+  for (size_t n : {1, 7, 64, 300}) {
+    auto a = RandomPolynomial<int64_t>(n, gen);
+    auto b = RandomPolynomial<int64_t>(n / 2 + 1, gen);
+    RequireEqual(a * b, NaiveMultiply(a, b));
+  }
+}
+
+TEST_CASE("Modular polynomial multiplication") {
+  using Mint = Z<998'244'353>;
+
+  std::mt19937 rnd(239);
+  auto gen = [&] { return static_cast<int64_t>(rnd() % 998'244'353); };
+  for (size_t n : {1, 2, 5, 128, 1000}) {
+    auto a = RandomPolynomial<Mint>(n, gen);
+    auto b = RandomPolynomial<Mint>(n + 3, gen);
+    RequireEqual(a * b, NaiveMultiply(a, b));
+  }
+}
+
+TEST_CASE("Polynomial power") {
+  using Mint = Z<998'244'353>;
+  Polynomial<Mint> f{Mint(1), Mint(2)};
+
+  // Polynomial(1) is a size, zero power is polynomial 1 anyway.
+  RequireEqual(BinPow(f, 0), Polynomial<Mint>{Mint(1)});
+  RequireEqual(BinPow(f, 1), f);
+  RequireEqual(BinPow(f, 3), Polynomial<Mint>{Mint(1), Mint(6), Mint(12), Mint(8)});
+}
+
+TEST_CASE("Root of unity for NTT-friendly modulo") {
+  using Mint = Z<998'244'353>;
+
+  auto root = fft::detail::root<Mint>(1 << 23);
+  REQUIRE(BinPow(root, 1 << 23) == Mint(1));
+  REQUIRE(BinPow(root, 1 << 22) != Mint(1));
+}
+
+TEST_CASE("Compile-time NTT parameters") {
+  using Traits = fft::ntt_traits<998'244'353>;
+  static_assert(Traits::kPrimitiveRoot == 3);
+  static_assert(Traits::kMaxLog == 23);
+  static_assert(Traits::kMaxSize == (1 << 23));
+  static_assert(fft::ntt_traits<167'772'161>::kMaxLog == 25);
+  static_assert(fft::ntt_traits<(int64_t{1} << 62) + 135>::kMaxLog == 1);
+  static_assert(fft::static_modulo<Z<7>>::value == 7);
+  static_assert(fft::static_modulo<MontgomeryZ<7>>::value == 7);
+  static_assert(fft::static_modulo<DynamicModular<int64_t>>::value == 0);
+
+  using Mint = Z<998'244'353>;
+  for (int log = 0; log <= Traits::kMaxLog; ++log) {
+    Mint root(Traits::kRoots[log]), inverse(Traits::kInverseRoots[log]);
+    REQUIRE(root * inverse == Mint(1));
+    REQUIRE(BinPow(root, int64_t{1} << log) == Mint(1));
+    if (log > 0) REQUIRE(BinPow(root, int64_t{1} << (log - 1)) == Mint(-1));
+  }
+
+  // Composite modulo skips NTT at compile time and goes to multiply_mod.
+  using Composite = Z<1'000'000'000>;
+  std::mt19937 rnd(5);
+  auto gen = [&] { return static_cast<int64_t>(rnd() % 1'000'000'000); };
+  auto a = RandomPolynomial<Composite>(300, gen), b = RandomPolynomial<Composite>(200, gen);
+  RequireEqual(a * b, NaiveMultiply(a, b));
+}
+
+TEST_CASE("Cached plan round trip") {
+  using Num = std::complex<long double>;
+
+  std::mt19937 rnd(239);
+  for (size_t size : {1, 2, 16, 1024}) {
+    const auto &plan = fft::plan<Num>(size);
+    REQUIRE(&plan == &fft::plan<Num>(size));
+
+    std::vector<Num> values(size), expected(size);
+    for (auto &value : values) value = Num(rnd() % 1000, rnd() % 1000);
+    for (size_t k = 0; k < size; ++k) {
+      for (size_t j = 0; j < size; ++j) {
+        expected[k] += values[j] * std::pow(plan.base(), k * j % size);
+      }
+    }
+
+    auto transformed = values;
+    plan.Forward(transformed.begin(), transformed.end());
+    for (size_t k = 0; k < size; ++k) {
+      REQUIRE(std::abs(transformed[k] - expected[k]) < 1e-6);
+    }
+
+    plan.Inverse(transformed.begin(), transformed.end());
+    for (size_t k = 0; k < size; ++k) {
+      REQUIRE(std::abs(transformed[k] - values[k]) < 1e-9);
+    }
+  }
+}
+
+TEST_CASE("Integer multiplication precision") {
+  std::mt19937_64 rnd(239);
+  for (int64_t bound : {1'000, 100'000, 1'000'000}) {
+    std::vector<int64_t> lhs(5000), rhs(3000);
+    for (auto &x : lhs) x = static_cast<int64_t>(rnd() % (2 * bound)) - bound;
+    for (auto &x : rhs) x = static_cast<int64_t>(rnd() % (2 * bound)) - bound;
+
+    auto result = fft::multiply_integer(lhs, rhs);
+    REQUIRE(result.size() == lhs.size() + rhs.size() - 1);
+    for (size_t k : {size_t{0}, size_t{1}, size_t{2999}, size_t{4321}, result.size() - 1}) {
+      int64_t expected = 0;
+      for (size_t i = 0; i <= k && i < lhs.size(); ++i) {
+        if (k - i < rhs.size()) expected += lhs[i] * rhs[k - i];
+      }
+      REQUIRE(result[k] == expected);
+    }
+  }
+}
+
+TEST_CASE("Montgomery polynomial multiplication") {
+  using Mint = MontgomeryZ<998'244'353>;
+
+  std::mt19937 rnd(239);
+  auto gen = [&] { return static_cast<int64_t>(rnd()); };
+  for (size_t n : {1, 3, 100, 777}) {
+    auto a = RandomPolynomial<Mint>(n, gen);
+    auto b = RandomPolynomial<Mint>(2 * n, gen);
+    RequireEqual(a * b, NaiveMultiply(a, b));
+  }
+}
+
+TEST_CASE("Runtime modulo polynomial multiplication") {
+  using Mint = BarrettModular<>;
+  BarrettModulo<> modulo(998'244'353);
+
+  std::mt19937 rnd(239);
+  auto gen = [&] { return static_cast<int64_t>(rnd()); };
+  for (size_t n : {1, 4, 100, 513}) {
+    auto a = RandomPolynomial<Mint>(n, gen);
+    auto b = RandomPolynomial<Mint>(n + 1, gen);
+    RequireEqual(a * b, NaiveMultiply(a, b));
+  }
+}
+
+TEST_CASE("Power series operations") {
+  using Mint = Z<998'244'353>;
+
+  std::mt19937 rnd(239);
+  auto gen = [&] { return static_cast<int64_t>(rnd() % 998'244'353); };
+
+  for (size_t n : {1, 2, 5, 64, 300}) {
+    auto f = RandomPolynomial<Mint>(n, gen);
+    f[0] = Mint(1);
+
+    auto one = (f * f.Inverse(n)).Truncated(n);
+    RequireEqual(one, Polynomial<Mint>{Mint(1)}.Truncated(n));
+
+    RequireEqual(f.Log(n).Exp(n), f);
+
+    auto root = f.Sqrt(n);
+    RequireEqual((root * root).Truncated(n), f);
+
+    auto cube = (f * f * f).Truncated(n);
+    RequireEqual(f.Pow(3, n), cube);
+  }
+}
+
+TEST_CASE("Power series power with leading zeros") {
+  using Mint = Z<998'244'353>;
+
+  auto f = Polynomial<Mint>{Mint(0), Mint(0), Mint(2), Mint(1)};
+  RequireEqual(f.Pow(0, 4), Polynomial<Mint>{Mint(1), Mint(0), Mint(0), Mint(0)});
+  RequireEqual(f.Pow(2, 8), Polynomial<Mint>{
+      Mint(0), Mint(0), Mint(0), Mint(0), Mint(4), Mint(4), Mint(1), Mint(0)});
+  RequireEqual(f.Pow(1'000'000'000'000'000'000LL, 8), Polynomial<Mint>(8));
+}
+
+TEMPLATE_TEST_CASE("Power series power with exponent above modulo", "",
+                   Z<998'244'353>, MontgomeryZ<998'244'353>) {
+  const int64_t mod = 998'244'353;
+
+  // (1 + x)^(p + 3) = (1 + x^p) (1 + x)^3, which is (1 + x)^3 below x^p.
+  auto f = Polynomial<TestType>{TestType(1), TestType(1)};
+  auto cube = Polynomial<TestType>{TestType(1), TestType(3), TestType(3), TestType(1), TestType(0)};
+  RequireEqual(f.Pow(mod + 3, 5), cube);
+  RequireEqual(f.Pow(5 * mod + 3, 5), cube);
+}
+
+TEST_CASE("Polynomial division with remainder") {
+  using Mint = Z<998'244'353>;
+
+  std::mt19937 rnd(239);
+  auto gen = [&] { return static_cast<int64_t>(rnd() % 998'244'353); };
+
+  for (auto [n, m] : std::vector<std::pair<size_t, size_t>>{{1, 1}, {5, 2}, {3, 7}, {200, 77}}) {
+    auto a = RandomPolynomial<Mint>(n, gen), b = RandomPolynomial<Mint>(m, gen);
+    b[m - 1] = Mint(1);
+
+    auto [quotient, remainder] = a.DivMod(b);
+    REQUIRE(remainder.degree() < b.degree());
+
+    auto restored = quotient * b + remainder;
+    restored.Trim(), a.Trim();
+    RequireEqual(restored, a);
+  }
+}
+
+TEST_CASE("Multipoint evaluation and interpolation") {
+  using Mint = Z<998'244'353>;
+
+  std::mt19937 rnd(239);
+  auto gen = [&] { return static_cast<int64_t>(rnd() % 998'244'353); };
+
+  for (size_t n : {1, 2, 33, 500}) {
+    std::vector<Mint> points(n);
+    for (size_t i = 0; i < n; ++i) points[i] = Mint(static_cast<int64_t>(3 * i + 1));
+
+    auto tree = SubproductTree<Mint>(points);
+    for (size_t degree : {size_t{1}, n, 2 * n + 3}) {
+      auto f = RandomPolynomial<Mint>(degree, gen);
+      auto values = tree.Evaluate(f);
+      for (size_t i = 0; i < n; ++i) {
+        REQUIRE(values[i] == f(points[i]));
+      }
+    }
+
+    auto f = RandomPolynomial<Mint>(n, gen);
+    RequireEqual(tree.Interpolate(tree.Evaluate(f)), f);
+    RequireEqual(Interpolate(points, Evaluate(f, points)), f);
+  }
+}
+
+TEST_CASE("Arbitrary modulo multiplication") {
+  std::mt19937_64 rnd(239);
+  for (int64_t mod : {int64_t{1'000'000'007}, int64_t{998'244'353}, (int64_t{1} << 61) - 1}) {
+    for (auto [n, m] : std::vector<std::pair<size_t, size_t>>{{1, 1}, {3, 10}, {1000, 777}}) {
+      std::vector<int64_t> lhs(n), rhs(m);
+      for (auto &x : lhs) x = static_cast<int64_t>(rnd() % mod);
+      for (auto &x : rhs) x = static_cast<int64_t>(rnd() % mod);
+
+      std::vector<int64_t> expected(n + m - 1);
+      for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < m; ++j) {
+          expected[i + j] = static_cast<int64_t>(
+              (expected[i + j] + static_cast<__int128>(lhs[i]) * rhs[j]) % mod);
+        }
+      }
+
+      REQUIRE(fft::multiply_mod(lhs, rhs, mod) == expected);
+      REQUIRE(fft::detail::multiply_crt(lhs, rhs, mod) == expected);
+    }
+  }
+}
+
+TEST_CASE("Split multiplication stays exact near 2^31") {
+  const int64_t mod = (int64_t{1} << 31) - 1;
+
+  // All coefficients are mod - 1 = -1, so k-th one of product is a number of pairs.
+  const size_t n = size_t{1} << 19;
+  std::vector<int64_t> lhs(n, mod - 1), rhs(n, mod - 1);
+  auto product = fft::multiply_mod(lhs, rhs, mod);
+  REQUIRE(product.size() == 2 * n - 1);
+  for (size_t k = 0; k < product.size(); ++k) {
+    REQUIRE(product[k] == static_cast<int64_t>(std::min(k + 1, 2 * n - 1 - k)));
+  }
+
+  std::mt19937_64 rnd(239);
+  for (size_t size : {size_t{1} << 10, size_t{1} << 12, size_t{1} << 15}) {
+    std::vector<int64_t> a(size), b(size);
+    for (auto &x : a) x = mod - 1 - static_cast<int64_t>(rnd() % 1000);
+    for (auto &x : b) x = mod - 1 - static_cast<int64_t>(rnd() % 1000);
+    auto expected = fft::detail::multiply_crt(a, b, mod);
+    REQUIRE(fft::multiply_mod(a, b, mod) == expected);
+    if (fft::detail::split_is_exact(mod, size, size)) {
+      REQUIRE(fft::detail::multiply_split(a, b, mod) == expected);
+    }
+  }
+}
+
+TEST_CASE("CRT multiplication stays exact near 2^62") {
+  const int64_t mod = (int64_t{1} << 62) - 57;
+
+  // Coefficients of product reach (mod - 1)^2 * 2^22, that needs six primes.
+  const size_t n = size_t{1} << 22;
+  std::vector<int64_t> lhs(n, mod - 1), rhs(n, mod - 1);
+  std::vector<int64_t> expected(2 * n - 1);
+  for (size_t k = 0; k < expected.size(); ++k) {
+    expected[k] = static_cast<int64_t>(std::min(k + 1, 2 * n - 1 - k));
+  }
+  REQUIRE(fft::multiply_mod(lhs, rhs, mod) == expected);
+}
+
+TEST_CASE("Runtime arbitrary modulo polynomial multiplication") {
+  using Mint = BarrettModular<>;
+  BarrettModulo<> modulo(1'000'000'007);
+
+  std::mt19937 rnd(239);
+  auto gen = [&] { return static_cast<int64_t>(rnd()); };
+  for (size_t n : {1, 4, 100, 513}) {
+    auto a = RandomPolynomial<Mint>(n, gen);
+    auto b = RandomPolynomial<Mint>(n + 1, gen);
+    RequireEqual(a * b, NaiveMultiply(a, b));
+  }
+}
+
+TEST_CASE("Parallel transform is deterministic") {
+  using Num = std::complex<long double>;
+  using Mint = Z<998'244'353>;
+
+  std::mt19937 rnd(239);
+  for (size_t size : {1, 2, 8, 1 << 12}) {
+    std::vector<Num> values(size);
+    std::vector<Mint> residues(size);
+    for (size_t i = 0; i < size; ++i) {
+      values[i] = Num(rnd() % 1000, rnd() % 1000);
+      residues[i] = Mint(static_cast<int64_t>(rnd() % 998'244'353));
+    }
+
+    auto expected_values = values;
+    auto expected_residues = residues;
+    fft::plan<Num>(size).Forward(expected_values.begin(), expected_values.end());
+    fft::plan<Mint>(size).Forward(expected_residues.begin(), expected_residues.end());
+
+    for (size_t threads : {2, 3, 4, 16}) {
+      auto actual_values = values;
+      auto actual_residues = residues;
+      fft::plan<Num>(size).Forward(actual_values.begin(), actual_values.end(), threads);
+      fft::plan<Mint>(size).Forward(actual_residues.begin(), actual_residues.end(), threads);
+
+      REQUIRE(actual_values == expected_values);
+      for (size_t i = 0; i < size; ++i) REQUIRE(actual_residues[i] == expected_residues[i]);
+    }
+  }
+}
+
+TEST_CASE("Multiplication kernels agree") {
+  using Mint = Z<1'000'000'007>;
+
+  std::mt19937 rnd(239);
+  for (auto [n, m] : std::vector<std::pair<size_t, size_t>>{{1, 1}, {65, 65}, {100, 1}, {129, 200}, {5000, 70}}) {
+    std::vector<Mint> lhs(n), rhs(m);
+    std::vector<int64_t> int_lhs(n), int_rhs(m);
+    for (size_t i = 0; i < n; ++i) lhs[i] = Mint(int_lhs[i] = rnd() % 1000);
+    for (size_t i = 0; i < m; ++i) rhs[i] = Mint(int_rhs[i] = rnd() % 1000);
+
+    auto expected = convolution::schoolbook(lhs, rhs);
+    auto karatsuba = convolution::karatsuba(lhs, rhs);
+    auto transform = convolution::transform(lhs, rhs);
+    auto product = convolution::multiply(lhs, rhs);
+    auto int_product = convolution::multiply(int_lhs, int_rhs);
+
+    REQUIRE(karatsuba.size() == expected.size());
+    REQUIRE(transform.size() == expected.size());
+    REQUIRE(product.size() == expected.size());
+    REQUIRE(int_product.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      REQUIRE(karatsuba[i] == expected[i]);
+      REQUIRE(transform[i] == expected[i]);
+      REQUIRE(product[i] == expected[i]);
+      REQUIRE(Mint(int_product[i]) == expected[i]);
+    }
+  }
+}
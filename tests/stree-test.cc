@@ -1,5 +1,10 @@
 #include <catch2/catch_all.hpp>
 
+#include <algorithm>
+#include <numeric>
+#include <string>
+
+#include "../data-structures/segment-tree/bottom-up.hpp"
 #include "../data-structures/segment-tree/segment-tree.hpp"
 
 struct SumData {
@@ -111,3 +116,251 @@ TEST_CASE("Pure maxtree test") {
   set(3, 7);
   REQUIRE(find(6) == 3);
 }
+
+TEST_CASE("Array and vector storages agree") {
+  std::mt19937 rnd(239);
+  for (int size : {1, 2, 3, 7, 64, 100, 1000}) {
+    std::vector<int64_t> xs(size);
+    for (auto &x : xs) x = rnd() % 1000;
+    auto array = segment_tree::build<SumData, segment_tree::ArrayStorage>(xs);
+    auto vector = segment_tree::build<SumData, segment_tree::VectorStorage>(xs);
+
+    for (int step = 0; step < 1000; ++step) {
+      int index = rnd() % size;
+      int64_t value = rnd() % 1000;
+      Setter<int64_t>{index, value}.set(array.Root());
+      Setter<int64_t>{index, value}.set(vector.Root());
+      xs[index] = value;
+
+      int l = rnd() % size, r = rnd() % size;
+      if (l > r) std::swap(l, r);
+      int64_t expected = std::accumulate(xs.begin() + l, xs.begin() + r + 1, int64_t{0});
+      REQUIRE(array.Fold(l, r + 1) == expected);
+      REQUIRE(vector.Fold(l, r + 1) == expected);
+    }
+  }
+}
+
+// Affine maps wrap around modulo 2^64, so they compose exactly.
+template <template <class, class> class Storage>
+void CheckAffineSum() {
+  using segment_tree::Affine;
+  std::mt19937_64 rnd(239);
+  for (int size : {1, 2, 5, 64, 100, 1000}) {
+    std::vector<uint64_t> xs(size);
+    for (auto &x : xs) x = rnd();
+    auto stree = segment_tree::build<segment_tree::AffineSum<uint64_t>, Storage>(xs);
+
+    for (int step = 0; step < 1000; ++step) {
+      int l = rnd() % size, r = rnd() % size;
+      if (l > r) std::swap(l, r);
+      if (step % 3 == 0) {
+        REQUIRE(stree.Fold(l, r + 1) == std::accumulate(xs.begin() + l, xs.begin() + r + 1, uint64_t{0}));
+        continue;
+      }
+
+      // Assignments, additions and general maps.
+      Affine<uint64_t> tag{rnd() % 3 ? rnd() : rnd() % 2, rnd()};
+      stree.Apply(l, r + 1, tag);
+      for (int i = l; i <= r; ++i) xs[i] = tag.mul * xs[i] + tag.add;
+    }
+    for (int i = 0; i < size; ++i) {
+      REQUIRE(stree.Fold(i, i + 1) == xs[i]);
+    }
+  }
+}
+
+TEST_CASE("Lazy affine maps over sums") {
+  CheckAffineSum<segment_tree::ArrayStorage>();
+  CheckAffineSum<segment_tree::VectorStorage>();
+}
+
+TEST_CASE("Lazy additions keep walkers working") {
+  std::mt19937 rnd(239);
+  std::vector<int64_t> xs(200);
+  for (auto &x : xs) x = rnd() % 1000;
+  auto stree = segment_tree::build<segment_tree::AddMax<int64_t>>(xs);
+
+  for (int step = 0; step < 1000; ++step) {
+    int l = rnd() % xs.size(), r = rnd() % xs.size();
+    if (l > r) std::swap(l, r);
+    int64_t delta = static_cast<int64_t>(rnd() % 100) - 50;
+    stree.Apply(l, r + 1, delta);
+    for (int i = l; i <= r; ++i) xs[i] += delta;
+
+    int64_t value = static_cast<int64_t>(rnd() % 1500) - 250;
+    auto it = std::find_if(xs.begin(), xs.end(), [&](int64_t x) { return x >= value; });
+    int expected = it == xs.end() ? -1 : static_cast<int>(it - xs.begin());
+    REQUIRE(AtLeastFinder<int64_t>{value}.Find(stree.Root()) == expected);
+    REQUIRE(stree.Fold(l, r + 1) == *std::max_element(xs.begin() + l, xs.begin() + r + 1));
+  }
+}
+
+struct ConcatData {
+  static auto Pure(int value) { return std::to_string(value) + " "; }
+  static auto Merge(const std::string &lhs, const std::string &rhs) { return lhs + rhs; }
+};
+
+TEST_CASE("Bottom-up tree agrees with STree") {
+  std::mt19937 rnd(239);
+  for (int size : {1, 2, 3, 7, 64, 100, 1000}) {
+    std::vector<int64_t> xs(size);
+    for (auto &x : xs) x = rnd() % 1000;
+    auto stree = segment_tree::build<MaxData>(xs);
+    segment_tree::BottomUpTree<SumData> sums(xs);
+    segment_tree::BottomUpTree<MaxData, int64_t> maxima(xs);
+
+    for (int step = 0; step < 1000; ++step) {
+      int index = rnd() % size;
+      int64_t value = rnd() % 1000;
+      Setter<int64_t>{index, value}.set(stree.Root());
+      sums.Set(index, value), maxima.Set(index, value);
+      xs[index] = value;
+      REQUIRE(sums.Get(index) == value);
+
+      int l = rnd() % size, r = rnd() % size;
+      if (l > r) std::swap(l, r);
+      REQUIRE(sums.Fold(l, r + 1) == std::accumulate(xs.begin() + l, xs.begin() + r + 1, int64_t{0}));
+      REQUIRE(maxima.Fold(l, r + 1) == stree.Fold(l, r + 1));
+    }
+  }
+}
+
+TEST_CASE("Bottom-up tree keeps order of operands") {
+  for (int size : {1, 5, 13, 32}) {
+    segment_tree::BottomUpTree<ConcatData> stree(size, [](int index) { return index; });
+    for (int l = 0; l < size; ++l) {
+      std::string expected;
+      for (int r = l; r < size; ++r) {
+        expected += std::to_string(r) + " ";
+        REQUIRE(stree.Fold(l, r + 1) == expected);
+      }
+    }
+  }
+}
+
+TEST_CASE("Persistent storage keeps all the versions") {
+  std::mt19937 rnd(239);
+  const int size = 100;
+  std::vector<std::vector<int>> history{std::vector<int>(size)};
+  for (auto &x : history[0]) x = rnd() % 1000;
+  auto stree = segment_tree::build<MaxData, segment_tree::PersistentStorage>(history[0]);
+
+  for (int version = 1; version < 200; ++version) {
+    int base = rnd() % version;
+    REQUIRE(stree.Fork(base) == version);
+    history.push_back(history[base]);
+    for (int step = 0; step < 3; ++step) {
+      int index = rnd() % size, value = rnd() % 1000;
+      Setter<int>{index, value}.set(stree.Root());
+      history.back()[index] = value;
+    }
+  }
+
+  for (int version = 0; version < 200; ++version) {
+    const auto &xs = history[version];
+    for (int step = 0; step < 20; ++step) {
+      int value = rnd() % 1000;
+      auto it = std::find_if(xs.begin(), xs.end(), [&](int x) { return x >= value; });
+      int expected = it == xs.end() ? -1 : static_cast<int>(it - xs.begin());
+      REQUIRE(AtLeastFinder<int>{value}.Find(stree.Root(version)) == expected);
+
+      int l = rnd() % size, r = rnd() % size;
+      if (l > r) std::swap(l, r);
+      auto fold = segment_tree::RangeQuery<MaxData>{l, r + 1, {}}.perform(stree.Root(version));
+      REQUIRE(fold == *std::max_element(xs.begin() + l, xs.begin() + r + 1));
+    }
+  }
+}
+
+TEST_CASE("Persistent storage copies only paths") {
+  using Storage = segment_tree::PersistentStorage<SumData>;
+  using Walker = segment_tree::Walker<Storage::NodeReference>;
+  using ConstWalker = segment_tree::Walker<Storage::ConstNodeReference>;
+  const int size = 1000, depth = 10;
+  Storage storage(size);
+  auto iota = [](int index) { return int64_t{index}; };
+  segment_tree::Builder<decltype(iota)>{iota}.build(Walker{storage.Root(), 0, size});
+  REQUIRE(storage.nodes() == 2 * size);
+
+  for (int version = 1; version <= 100; ++version) {
+    size_t before = storage.nodes();
+    storage.Fork(version - 1);
+    Setter<int64_t>{version, 0}.set(Walker{storage.Root(), 0, size});
+    REQUIRE(storage.nodes() - before <= depth + 1);
+  }
+  REQUIRE(segment_tree::RangeQuery<SumData>{0, size, {}}.perform(ConstWalker{storage.Root(0), 0, size}) ==
+          size * (size - 1) / 2);
+  REQUIRE(segment_tree::RangeQuery<SumData>{0, size, {}}.perform(ConstWalker{storage.Root(100), 0, size}) ==
+          size * (size - 1) / 2 - 100 * 101 / 2);
+
+  storage.Rollback(50);
+  REQUIRE(storage.latest() == 50);
+  REQUIRE(storage.nodes() <= 2 * size + 50 * (depth + 1));
+  REQUIRE(segment_tree::RangeQuery<SumData>{0, size, {}}.perform(ConstWalker{storage.Root(50), 0, size}) ==
+          size * (size - 1) / 2 - 50 * 51 / 2);
+}
+
+struct Adder {
+  int index;
+  int64_t delta;
+
+  template <class Walker>
+  void add(Walker walker) {
+    if (walker.size() == 1) {
+      walker.Get() += delta;
+    } else {
+      add(index < walker.mid() ? walker.Left() : walker.Right());
+      walker.Update();
+    }
+  }
+};
+
+// k-th smallest value among those added between versions lo and hi.
+template <class Walker>
+int KthSmallest(Walker lo, Walker hi, int64_t k) {
+  if (hi.size() == 1) {
+    return hi.left;
+  }
+  int64_t left = hi.Left().Get() - lo.Left().Get();
+  return k < left ? KthSmallest(lo.Left(), hi.Left(), k) : KthSmallest(lo.Right(), hi.Right(), k - left);
+}
+
+TEST_CASE("Persistent folds copy no nodes") {
+  std::vector<int64_t> xs(1000);
+  std::iota(xs.begin(), xs.end(), 0);
+  segment_tree::STree<segment_tree::PersistentStorage<SumData>> stree(1000);
+  stree.Build([&](int index) { return xs[index]; });
+  stree.Fork(0);
+  Setter<int64_t>{10, 0}.set(stree.Root());
+
+  const size_t nodes = stree.storage().nodes();
+  for (int l = 0; l < 1000; l += 7) {
+    REQUIRE(stree.Fold(l, 1000) == std::accumulate(xs.begin() + l, xs.end(), int64_t{0}) - (l <= 10 ? 10 : 0));
+    REQUIRE(AtLeastFinder<int64_t>{500}.Find(stree.Root(1)) == 500);
+  }
+  REQUIRE(stree.storage().nodes() == nodes);
+}
+
+TEST_CASE("Persistent counts give k-th smallest on range") {
+  std::mt19937 rnd(239);
+  const int kValues = 1'000'000'000;
+  std::vector<int> xs(300);
+  for (auto &x : xs) x = rnd() % kValues;
+
+  // Version i counts values of xs[0, i), the tree over all values is never built.
+  segment_tree::STree<segment_tree::PersistentStorage<SumData>> stree(kValues);
+  for (size_t i = 0; i < xs.size(); ++i) {
+    stree.Fork(static_cast<int>(i));
+    Adder{xs[i], 1}.add(stree.Root());
+  }
+
+  for (int step = 0; step < 1000; ++step) {
+    int l = rnd() % xs.size(), r = rnd() % xs.size();
+    if (l > r) std::swap(l, r);
+    std::vector<int> range(xs.begin() + l, xs.begin() + r + 1);
+    std::sort(range.begin(), range.end());
+    int k = rnd() % range.size();
+    REQUIRE(KthSmallest(stree.Root(l), stree.Root(r + 1), k) == range[k]);
+  }
+}
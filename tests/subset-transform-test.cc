@@ -0,0 +1,73 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "../algebra/modular.hpp"
+#include "../algebra/montgomery.hpp"
+#include "../algebra/subset_transform.hpp"
+
+namespace {
+
+template <class T, class Combine, class Filter>
+std::vector<T> NaiveMultiply(const std::vector<T> &lhs, const std::vector<T> &rhs,
+                             Combine combine, Filter filter) {
+  std::vector<T> result(lhs.size(), T(0));
+  for (size_t i = 0; i < lhs.size(); ++i) {
+    for (size_t j = 0; j < rhs.size(); ++j) {
+      if (filter(i, j)) result[combine(i, j)] += lhs[i] * rhs[j];
+    }
+  }
+  return result;
+}
+
+template <class T>
+std::vector<T> RandomValues(size_t size, std::mt19937 &rnd) {
+  std::vector<T> result(size);
+  for (auto &value : result) value = T(static_cast<int64_t>(rnd() % 1000));
+  return result;
+}
+
+}  // namespace
+
+TEMPLATE_TEST_CASE("Bitwise convolutions", "", Z<998'244'353>, MontgomeryZ<998'244'353>, int64_t) {
+  std::mt19937 rnd(239);
+  auto any = [](size_t, size_t) { return true; };
+
+  for (size_t size : {1, 2, 4, 32, 256}) {
+    auto lhs = RandomValues<TestType>(size, rnd), rhs = RandomValues<TestType>(size, rnd);
+
+    REQUIRE(subset::xor_multiply(lhs, rhs) ==
+            NaiveMultiply(lhs, rhs, [](size_t i, size_t j) { return i ^ j; }, any));
+    REQUIRE(subset::or_multiply(lhs, rhs) ==
+            NaiveMultiply(lhs, rhs, [](size_t i, size_t j) { return i | j; }, any));
+    REQUIRE(subset::and_multiply(lhs, rhs) ==
+            NaiveMultiply(lhs, rhs, [](size_t i, size_t j) { return i & j; }, any));
+    REQUIRE(subset::subset_multiply(lhs, rhs) ==
+            NaiveMultiply(lhs, rhs, [](size_t i, size_t j) { return i | j; },
+                          [](size_t i, size_t j) { return (i & j) == 0; }));
+
+    auto values = lhs;
+    subset::hadamard(values), subset::inverse_hadamard(values);
+    REQUIRE(values == lhs);
+    subset::zeta_subsets(values), subset::mobius_subsets(values);
+    REQUIRE(values == lhs);
+    subset::zeta_supersets(values), subset::mobius_supersets(values);
+    REQUIRE(values == lhs);
+  }
+}
+
+TEST_CASE("Subset sums") {
+  std::vector<int64_t> values{1, 2, 4, 8};
+  subset::zeta_subsets(values);
+  REQUIRE(values == std::vector<int64_t>{1, 3, 5, 15});
+
+  values = {1, 2, 4, 8};
+  subset::zeta_supersets(values);
+  REQUIRE(values == std::vector<int64_t>{15, 10, 12, 8});
+
+  values = {1, 2, 4, 8};
+  subset::hadamard(values);
+  REQUIRE(values == std::vector<int64_t>{15, -5, -9, 3});
+}